@@ -0,0 +1,74 @@
+#include "net.hpp"
+
+#include <random>
+
+template <typename Word>
+static bool Run(const char* strName, const std::vector<Word>& vecValues, std::size_t nRounds) {
+    std::vector<uint8_t> vecPacked(net::bitpack_bound<Word>(vecValues.size()));
+    std::vector<Word> vecDecoded(vecValues.size());
+    double dRawMiB = double(vecValues.size() * sizeof(Word)) * double(nRounds) / (1024.0 * 1024.0);
+
+    for (const net::bitpack_kernels<Word>& kernels : { net::bitpack_scalar_kernels<Word>(), net::bitpack_best_kernels<Word>() }) {
+        uint8_t* pEnd = nullptr;
+        auto tStart = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < nRounds; i++) {
+            pEnd = net::bitpack_encode(vecPacked.data(), vecValues.data(), vecValues.size(), kernels);
+        }
+        double dEncode = std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+
+        const uint8_t* pDecoded = nullptr;
+        tStart = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < nRounds; i++) {
+            pDecoded = net::bitpack_decode(vecPacked.data(), pEnd, vecDecoded.data(), vecDecoded.size(), kernels);
+        }
+        double dDecode = std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+
+        if (pDecoded != pEnd || vecDecoded != vecValues) {
+            std::cout << strName << " " << kernels.strName << " round trip failed\n";
+            return false;
+        }
+
+        std::size_t nPacked = std::size_t(pEnd - vecPacked.data());
+        std::cout << strName << " kernels=" << kernels.strName << " words=" << vecValues.size() << "x" << sizeof(Word) * 8 << "b"
+            << " ratio=" << double(vecValues.size() * sizeof(Word)) / double(nPacked)
+            << " encode=" << dRawMiB / dEncode << " MiB/s decode=" << dRawMiB / dDecode << " MiB/s\n";
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t nCount = argc > 1 ? std::stoul(argv[1]) : 1 << 16;
+    std::size_t nRounds = argc > 2 ? std::stoul(argv[2]) : 2000;
+
+    std::mt19937_64 rng(42);
+
+    std::vector<uint32_t> vecIds(nCount);
+    uint32_t nId = 1000;
+    for (uint32_t& id : vecIds) {
+        id = nId += 1 + uint32_t(rng() % 8);
+    }
+
+    std::vector<uint64_t> vecTimestamps(nCount);
+    uint64_t nTimestamp = 1700000000000000ull;
+    for (uint64_t& timestamp : vecTimestamps) {
+        timestamp = nTimestamp += 16000 + rng() % 2000;
+    }
+
+    std::vector<uint32_t> vecPositions(nCount);
+    int32_t nPosition = 0;
+    for (uint32_t& position : vecPositions) {
+        nPosition += int32_t(rng() % 512) - 256;
+        position = uint32_t(nPosition);
+    }
+
+    std::vector<uint32_t> vecRandom(nCount);
+    for (uint32_t& value : vecRandom) {
+        value = uint32_t(rng());
+    }
+
+    bool bOk = Run("ids", vecIds, nRounds);
+    bOk = Run("timestamps", vecTimestamps, nRounds) && bOk;
+    bOk = Run("positions", vecPositions, nRounds) && bOk;
+    bOk = Run("random", vecRandom, nRounds) && bOk;
+    return bOk ? 0 : 1;
+}
@@ -0,0 +1,35 @@
+#include "net.hpp"
+
+template<typename Fn>
+static double Measure(Fn fn, const std::vector<uint8_t>& vecData, std::size_t nSize, std::size_t nTotalBytes) {
+    std::size_t nIterations = std::max<std::size_t>(nTotalBytes / nSize, 1);
+    volatile uint32_t nSink = 0;
+    auto tStart = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < nIterations; i++) {
+        nSink = fn(nSink, vecData.data(), nSize);
+    }
+    double dSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+    return double(nIterations) * double(nSize) / dSeconds / (1024.0 * 1024.0 * 1024.0);
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t nTotalBytes = argc > 1 ? std::stoul(argv[1]) : std::size_t(1) << 30;
+
+    std::vector<uint8_t> vecData(std::size_t(1) << 20);
+    for (std::size_t i = 0; i < vecData.size(); i++) {
+        vecData[i] = uint8_t(i * 131 + (i >> 7));
+    }
+
+    if (net::crc32c_table(0, vecData.data(), vecData.size()) != net::crc32c(0, vecData.data(), vecData.size())) {
+        std::cout << "crc32c implementations disagree\n";
+        return 1;
+    }
+
+    std::cout << "hardware=" << (net::crc32c_hardware_available() ? "yes" : "no") << "\n";
+    for (std::size_t nSize : { std::size_t(64), std::size_t(256), std::size_t(1024), std::size_t(16384), vecData.size() }) {
+        double dTable = Measure(net::crc32c_table, vecData, nSize, nTotalBytes);
+        double dHardware = Measure(net::crc32c, vecData, nSize, nTotalBytes);
+        std::cout << "size=" << nSize << "B table=" << dTable << " GiB/s crc32c=" << dHardware << " GiB/s\n";
+    }
+    return 0;
+}
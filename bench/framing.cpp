@@ -0,0 +1,174 @@
+#include "net.hpp"
+
+enum class FramingMessage : uint16_t {
+    Ready,
+    Single,
+    Batched,
+    Snapshot = 700
+};
+
+template <>
+struct net::message_traits<FramingMessage> : net::default_message_traits {
+    using framing = net::compact_framing;
+};
+
+static net::message<FramingMessage> MakeSnapshot(std::size_t nBodySize) {
+    net::message<FramingMessage> msg;
+    msg.header.id = FramingMessage::Snapshot;
+    msg.body.resize(nBodySize);
+    for (std::size_t i = 0; i < nBodySize; i++) {
+        msg.body.data()[i] = uint8_t((i / 64) % 16);
+    }
+    return msg;
+}
+
+static net::message<FramingMessage> MakeSequenced(FramingMessage id, uint32_t nSequence) {
+    net::message<FramingMessage> msg;
+    msg.header.id = id;
+    msg << nSequence;
+    msg.body.resize(msg.body.size() + nSequence % 32);
+    return msg;
+}
+
+static bool IsSequenced(const net::message<FramingMessage>& msg, uint32_t nExpected) {
+    net::message_view<FramingMessage> view(msg);
+    uint32_t nSequence = 0;
+    view >> nSequence;
+    return view.ok() && nSequence == nExpected && view.remaining() == nSequence % 32 && msg.header.size == msg.size();
+}
+
+static bool IsSnapshot(const net::message<FramingMessage>& msg, std::size_t nBodySize) {
+    net::message<FramingMessage> expected = MakeSnapshot(nBodySize);
+    return msg.body.size() == nBodySize && std::memcmp(msg.body.data(), expected.body.data(), nBodySize) == 0 && msg.header.size == msg.size();
+}
+
+class FramingServer : public net::server_interface<FramingMessage> {
+public:
+    FramingServer(uint16_t nPort, std::size_t nSnapshotSize) : net::server_interface<FramingMessage>(nPort), nSnapshotSize(nSnapshotSize) {
+    }
+
+    std::size_t nSnapshotSize;
+    uint32_t nSingles = 0;
+    uint32_t nBatched = 0;
+    std::size_t nSnapshots = 0;
+    std::size_t nErrors = 0;
+
+protected:
+    bool OnClientConnect(std::shared_ptr<net::connection<FramingMessage>>) override {
+        return true;
+    }
+
+    void OnClientValidated(std::shared_ptr<net::connection<FramingMessage>> client) override {
+        net::message<FramingMessage> msg;
+        msg.header.id = FramingMessage::Ready;
+        MessageClient(client, std::move(msg));
+    }
+
+    void OnMessage(std::shared_ptr<net::connection<FramingMessage>> client, net::message<FramingMessage>& msg) override {
+        switch (msg.header.id) {
+            case FramingMessage::Single: {
+                nErrors += IsSequenced(msg, nSingles++) ? 0 : 1;
+                break;
+            }
+            case FramingMessage::Batched: {
+                nErrors += IsSequenced(msg, nBatched++) ? 0 : 1;
+                break;
+            }
+            case FramingMessage::Snapshot: {
+                nErrors += IsSnapshot(msg, nSnapshotSize) ? 0 : 1;
+                nSnapshots++;
+                net::message_batch<FramingMessage> batch;
+                for (uint32_t i = 0; i < 3; i++) {
+                    batch.append(MakeSequenced(FramingMessage::Batched, i));
+                }
+                MessageClient(client, std::move(batch));
+                MessageClient(client, MakeSnapshot(nSnapshotSize));
+                break;
+            }
+            default: {
+                nErrors++;
+                break;
+            }
+        }
+    }
+};
+
+int main(int argc, char* argv[]) {
+    std::size_t nMessages = argc > 1 ? std::stoul(argv[1]) : 100000;
+    uint16_t nPort = argc > 2 ? uint16_t(std::stoul(argv[2])) : 60200;
+    bool bChecksums = argc > 3 && std::stoul(argv[3]) != 0;
+    std::size_t nBatchSize = 64;
+    std::size_t nSnapshotSize = 256 * 1024;
+
+    FramingServer server(nPort, nSnapshotSize);
+    server.SetCompressionThreshold(1024);
+    server.SetChecksumsEnabled(bChecksums);
+    server.Start();
+
+    net::client_interface<FramingMessage> client;
+    client.SetCompressionThreshold(1024);
+    client.SetChecksumsEnabled(bChecksums);
+    client.Connect("127.0.0.1", nPort);
+    client.Incoming().wait();
+    client.Incoming().pop_front();
+
+    auto tStart = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < nMessages; i++) {
+        client.Send(MakeSequenced(FramingMessage::Single, uint32_t(i)));
+    }
+    while (server.nSingles < nMessages) {
+        server.Update(-1, true);
+    }
+    double dSingles = std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+
+    tStart = std::chrono::steady_clock::now();
+    net::message_batch<FramingMessage> batch;
+    for (std::size_t i = 0; i < nMessages; i++) {
+        batch.append(MakeSequenced(FramingMessage::Batched, uint32_t(i)));
+        if (batch.count() == nBatchSize || i + 1 == nMessages) {
+            client.Send(std::move(batch));
+            batch.clear();
+        }
+    }
+    while (server.nBatched < nMessages) {
+        server.Update(-1, true);
+    }
+    double dBatched = std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+
+    client.Send(MakeSnapshot(nSnapshotSize));
+    while (server.nSnapshots == 0) {
+        server.Update(-1, true);
+    }
+
+    std::size_t nClientErrors = 0;
+    std::size_t nReplies = 0;
+    while (nReplies < 4) {
+        client.Incoming().wait();
+        net::owned_message<FramingMessage> reply = client.Incoming().pop_front();
+        if (nReplies < 3) {
+            nClientErrors += reply.msg.header.id == FramingMessage::Batched && IsSequenced(reply.msg, uint32_t(nReplies)) ? 0 : 1;
+        }
+        else {
+            nClientErrors += reply.msg.header.id == FramingMessage::Snapshot && IsSnapshot(reply.msg, nSnapshotSize) ? 0 : 1;
+        }
+        nReplies++;
+    }
+
+    net::compression_stats stats = client.GetCompressionStats();
+    bool bCompressed = stats.nMessagesCompressed > 0 && stats.nMessagesDecompressed == 1;
+
+    std::cout << "framing=compact checksums=" << (bChecksums ? "on" : "off") << " messages=" << nMessages
+        << " single=" << double(nMessages) / dSingles / 1e6 << " Mmsg/s"
+        << " batched(" << nBatchSize << ")=" << double(nMessages) / dBatched / 1e6 << " Mmsg/s"
+        << " compression send=" << stats.send_ratio() << " receive=" << stats.receive_ratio() << "\n";
+
+    client.Disconnect();
+    server.Stop();
+
+    if (server.nErrors > 0 || nClientErrors > 0 || !bCompressed) {
+        std::cout << "round trip failed: server errors=" << server.nErrors << " client errors=" << nClientErrors
+            << " compressed=" << stats.nMessagesCompressed << " decompressed=" << stats.nMessagesDecompressed << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,106 @@
+#include "net.hpp"
+
+enum class BenchMessage : uint32_t {
+    Ready,
+    Payload
+};
+
+#if defined(SIMPLENET_BENCH_LOCKFREE_INCOMING)
+template <>
+struct net::message_traits<BenchMessage> : net::default_message_traits {
+    static constexpr bool bLockFreeIncoming = true;
+};
+static const char* strIncoming = "mpsc";
+#else
+static const char* strIncoming = "tsqueue";
+#endif
+
+#if defined(ASIO_HAS_IO_URING_AS_DEFAULT)
+static const char* strBackend = "io_uring";
+#else
+static const char* strBackend = "epoll";
+#endif
+
+class BenchServer : public net::server_interface<BenchMessage> {
+public:
+    BenchServer(uint16_t nPort) : net::server_interface<BenchMessage>(nPort) {
+    }
+
+    std::size_t nMessages = 0;
+    std::size_t nBytes = 0;
+
+protected:
+    bool OnClientConnect(std::shared_ptr<net::connection<BenchMessage>>) override {
+        return true;
+    }
+
+    void OnClientValidated(std::shared_ptr<net::connection<BenchMessage>> client) override {
+        net::message<BenchMessage> msg;
+        msg.header.id = BenchMessage::Ready;
+        MessageClient(client, std::move(msg));
+    }
+
+    void OnMessage(std::shared_ptr<net::connection<BenchMessage>>, net::message<BenchMessage>& msg) override {
+        nMessages++;
+        nBytes += msg.size();
+    }
+};
+
+int main(int argc, char* argv[]) {
+    std::size_t nClients = argc > 1 ? std::stoul(argv[1]) : 4;
+    std::size_t nMessagesPerClient = argc > 2 ? std::stoul(argv[2]) : 200000;
+    std::size_t nBodySize = argc > 3 ? std::stoul(argv[3]) : 64;
+    uint16_t nPort = argc > 4 ? uint16_t(std::stoul(argv[4])) : 60100;
+    bool bChecksums = argc > 5 && std::stoul(argv[5]) != 0;
+
+    BenchServer server(nPort);
+    server.SetChecksumsEnabled(bChecksums);
+    server.Start();
+
+    std::vector<std::unique_ptr<net::client_interface<BenchMessage>>> vecClients;
+    for (std::size_t i = 0; i < nClients; i++) {
+        vecClients.emplace_back(std::make_unique<net::client_interface<BenchMessage>>());
+        vecClients.back()->SetChecksumsEnabled(bChecksums);
+        vecClients.back()->Connect("127.0.0.1", nPort);
+    }
+    for (auto& client : vecClients) {
+        while (client->Incoming().empty()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        client->Incoming().pop_front();
+    }
+
+    net::message<BenchMessage> msg;
+    msg.header.id = BenchMessage::Payload;
+    msg.body.resize(nBodySize);
+    msg.header.size = uint32_t(msg.size());
+
+    auto tStart = std::chrono::steady_clock::now();
+    std::vector<std::thread> vecSenders;
+    for (auto& client : vecClients) {
+        vecSenders.emplace_back([&client, &msg, nMessagesPerClient]() {
+            for (std::size_t i = 0; i < nMessagesPerClient; i++) {
+                client->Send(msg);
+            }
+        });
+    }
+    std::size_t nExpected = nClients * nMessagesPerClient;
+    while (server.nMessages < nExpected) {
+        server.Update(-1, false);
+    }
+    double dSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+    for (auto& sender : vecSenders) {
+        sender.join();
+    }
+
+    std::cout << "backend=" << strBackend << " incoming=" << strIncoming << " clients=" << nClients << " messages=" << nExpected
+        << " body=" << nBodySize << "B checksums=" << (bChecksums ? "on" : "off") << " time=" << dSeconds << "s "
+        << double(nExpected) / dSeconds / 1e6 << " Mmsg/s "
+        << double(server.nBytes) / dSeconds / (1024.0 * 1024.0) << " MiB/s\n";
+
+    for (auto& client : vecClients) {
+        client->Disconnect();
+    }
+    server.Stop();
+    return 0;
+}
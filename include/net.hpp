@@ -2,6 +2,18 @@
 
 #include "net_common.hpp"
 #include "net_tsqueue.hpp"
+#include "net_ringqueue.hpp"
+#include "net_mpscqueue.hpp"
+#include "net_allocator.hpp"
+#include "net_smallbuffer.hpp"
+#include "net_reflect.hpp"
+#include "net_varint.hpp"
+#include "net_compress.hpp"
+#include "net_framing.hpp"
+#include "net_crc32c.hpp"
+#include "net_bitpack.hpp"
+#include "net_bufferpool.hpp"
+#include "net_socket.hpp"
 #include "net_message.hpp"
 #include "net_connection.hpp"
 #include "net_client.hpp"
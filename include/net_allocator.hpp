@@ -0,0 +1,81 @@
+#pragma once
+
+#include "net_common.hpp"
+
+namespace net {
+
+    class handler_memory {
+    public:
+        handler_memory() = default;
+        handler_memory(const handler_memory&) = delete;
+        handler_memory& operator=(const handler_memory&) = delete;
+
+        void* allocate(std::size_t nSize) {
+            if (nSize <= nSlotSize) {
+                for (auto& slot : m_slots) {
+                    if (!slot.bInUse.exchange(true, std::memory_order_acquire)) {
+                        return slot.storage;
+                    }
+                }
+            }
+            return ::operator new(nSize);
+        }
+
+        void deallocate(void* pointer) {
+            for (auto& slot : m_slots) {
+                if (pointer == slot.storage) {
+                    slot.bInUse.store(false, std::memory_order_release);
+                    return;
+                }
+            }
+            ::operator delete(pointer);
+        }
+
+    private:
+        static constexpr std::size_t nSlots = 4;
+        static constexpr std::size_t nSlotSize = 256;
+
+        struct slot {
+            alignas(std::max_align_t) unsigned char storage[nSlotSize];
+            std::atomic<bool> bInUse{false};
+        };
+
+        std::array<slot, nSlots> m_slots;
+    };
+
+    template <typename T>
+    class handler_allocator {
+    public:
+        using value_type = T;
+
+        explicit handler_allocator(handler_memory& memory) : m_pMemory(&memory) {
+        }
+
+        template <typename U>
+        handler_allocator(const handler_allocator<U>& other) : m_pMemory(other.m_pMemory) {
+        }
+
+        T* allocate(std::size_t n) const {
+            return static_cast<T*>(m_pMemory->allocate(sizeof(T) * n));
+        }
+
+        void deallocate(T* pointer, std::size_t) const {
+            m_pMemory->deallocate(pointer);
+        }
+
+        bool operator==(const handler_allocator& other) const {
+            return m_pMemory == other.m_pMemory;
+        }
+
+        bool operator!=(const handler_allocator& other) const {
+            return m_pMemory != other.m_pMemory;
+        }
+
+    private:
+        template <typename>
+        friend class handler_allocator;
+
+        handler_memory* m_pMemory;
+    };
+
+}
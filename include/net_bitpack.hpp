@@ -0,0 +1,301 @@
+#pragma once
+
+#include "net_common.hpp"
+#include "net_varint.hpp"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SIMPLENET_HAS_BITPACK_SIMD 1
+#endif
+
+#if defined(__GNUC__)
+#define SIMPLENET_ALWAYS_INLINE __attribute__((always_inline)) inline
+#else
+#define SIMPLENET_ALWAYS_INLINE inline
+#endif
+
+namespace net {
+
+    inline constexpr std::size_t nBitpackRowBytes = 32;
+    inline constexpr std::size_t nBitpackBlockSize = 256;
+    inline constexpr std::size_t nBitpackMaxCount = 1 << 20;
+
+    template <typename Word>
+    struct bitpack_kernels {
+        static_assert(std::is_same<Word, uint32_t>::value || std::is_same<Word, uint64_t>::value, "Bit packing only handles 32 and 64 bit words.\n");
+
+        std::size_t (*encode)(const Word* pIn, Word* pPrev, uint8_t* pOut);
+        void (*decode)(const uint8_t* pIn, unsigned nBits, Word* pOut, Word* pPrev);
+        const char* strName;
+    };
+
+    namespace detail {
+
+        inline unsigned bitpack_width(uint64_t nValue) {
+#if defined(__GNUC__)
+            return nValue == 0 ? 0 : 64 - unsigned(__builtin_clzll(nValue));
+#else
+            unsigned nBits = 0;
+            while (nValue != 0) {
+                nValue >>= 1;
+                nBits++;
+            }
+            return nBits;
+#endif
+        }
+
+        template <typename Word>
+        Word bitpack_zigzag_encode(Word nDelta) {
+            return Word(nDelta << 1) ^ Word(Word(0) - (nDelta >> (sizeof(Word) * 8 - 1)));
+        }
+
+        template <typename Word>
+        Word bitpack_zigzag_decode(Word nValue) {
+            return Word(nValue >> 1) ^ Word(Word(0) - (nValue & 1));
+        }
+
+        template <typename Word, typename Vec>
+        SIMPLENET_ALWAYS_INLINE std::size_t bitpack_encode_block(const Word* pIn, Word* pPrev, uint8_t* pOut) {
+            constexpr unsigned nWordBits = sizeof(Word) * 8;
+            constexpr std::size_t nColumns = nBitpackRowBytes / sizeof(Vec);
+            const uint8_t* pRows = reinterpret_cast<const uint8_t*>(pIn);
+            uint8_t* pPrevRow = reinterpret_cast<uint8_t*>(pPrev);
+
+            Vec used{};
+            for (std::size_t c = 0; c < nColumns; c++) {
+                Vec prev;
+                std::memcpy(&prev, pPrevRow + c * sizeof(Vec), sizeof(Vec));
+                for (std::size_t r = 0; r < nWordBits; r++) {
+                    Vec value;
+                    std::memcpy(&value, pRows + r * nBitpackRowBytes + c * sizeof(Vec), sizeof(Vec));
+                    Vec delta = value - prev;
+                    used |= (delta << 1) ^ (Word(0) - (delta >> (nWordBits - 1)));
+                    prev = value;
+                }
+            }
+            Word arrUsed[sizeof(Vec) / sizeof(Word)];
+            std::memcpy(arrUsed, &used, sizeof(Vec));
+            Word nUsed = 0;
+            for (Word nLane : arrUsed) {
+                nUsed |= nLane;
+            }
+
+            unsigned nBits = bitpack_width(nUsed);
+            pOut[0] = uint8_t(nBits);
+            uint8_t* pPacked = pOut + 1;
+            for (std::size_t c = 0; c < nColumns; c++) {
+                Vec prev;
+                std::memcpy(&prev, pPrevRow + c * sizeof(Vec), sizeof(Vec));
+                Vec packed{};
+                unsigned nFill = 0;
+                std::size_t nWord = 0;
+                for (std::size_t r = 0; r < nWordBits; r++) {
+                    Vec value;
+                    std::memcpy(&value, pRows + r * nBitpackRowBytes + c * sizeof(Vec), sizeof(Vec));
+                    Vec delta = value - prev;
+                    Vec zigzag = (delta << 1) ^ (Word(0) - (delta >> (nWordBits - 1)));
+                    prev = value;
+                    if (nBits == 0) {
+                        continue;
+                    }
+                    packed |= zigzag << nFill;
+                    nFill += nBits;
+                    if (nFill >= nWordBits) {
+                        std::memcpy(pPacked + nWord * nBitpackRowBytes + c * sizeof(Vec), &packed, sizeof(Vec));
+                        nWord++;
+                        nFill -= nWordBits;
+                        if (nFill > 0) {
+                            packed = zigzag >> (nBits - nFill);
+                        }
+                        else {
+                            packed = Vec{};
+                        }
+                    }
+                }
+                std::memcpy(pPrevRow + c * sizeof(Vec), &prev, sizeof(Vec));
+            }
+            return 1 + std::size_t(nBits) * nBitpackRowBytes;
+        }
+
+        template <typename Word, typename Vec>
+        SIMPLENET_ALWAYS_INLINE void bitpack_decode_block(const uint8_t* pIn, unsigned nBits, Word* pOut, Word* pPrev) {
+            constexpr unsigned nWordBits = sizeof(Word) * 8;
+            constexpr std::size_t nColumns = nBitpackRowBytes / sizeof(Vec);
+            uint8_t* pRows = reinterpret_cast<uint8_t*>(pOut);
+            uint8_t* pPrevRow = reinterpret_cast<uint8_t*>(pPrev);
+            Word nMask = nBits >= nWordBits ? Word(~Word(0)) : Word((Word(1) << nBits) - 1);
+
+            for (std::size_t c = 0; c < nColumns; c++) {
+                Vec prev;
+                std::memcpy(&prev, pPrevRow + c * sizeof(Vec), sizeof(Vec));
+                if (nBits == 0) {
+                    for (std::size_t r = 0; r < nWordBits; r++) {
+                        std::memcpy(pRows + r * nBitpackRowBytes + c * sizeof(Vec), &prev, sizeof(Vec));
+                    }
+                    continue;
+                }
+                Vec packed;
+                std::memcpy(&packed, pIn + c * sizeof(Vec), sizeof(Vec));
+                unsigned nFill = 0;
+                std::size_t nWord = 0;
+                for (std::size_t r = 0; r < nWordBits; r++) {
+                    Vec zigzag = (packed >> nFill) & nMask;
+                    nFill += nBits;
+                    if (nFill >= nWordBits) {
+                        nFill -= nWordBits;
+                        nWord++;
+                        if (nWord < nBits) {
+                            std::memcpy(&packed, pIn + nWord * nBitpackRowBytes + c * sizeof(Vec), sizeof(Vec));
+                            if (nFill > 0) {
+                                zigzag |= (packed << (nBits - nFill)) & nMask;
+                            }
+                        }
+                    }
+                    prev += (zigzag >> 1) ^ (Word(0) - (zigzag & 1));
+                    std::memcpy(pRows + r * nBitpackRowBytes + c * sizeof(Vec), &prev, sizeof(Vec));
+                }
+                std::memcpy(pPrevRow + c * sizeof(Vec), &prev, sizeof(Vec));
+            }
+        }
+
+        template <typename Word>
+        std::size_t bitpack_encode_block_scalar(const Word* pIn, Word* pPrev, uint8_t* pOut) {
+            return bitpack_encode_block<Word, Word>(pIn, pPrev, pOut);
+        }
+
+        template <typename Word>
+        void bitpack_decode_block_scalar(const uint8_t* pIn, unsigned nBits, Word* pOut, Word* pPrev) {
+            bitpack_decode_block<Word, Word>(pIn, nBits, pOut, pPrev);
+        }
+
+#if defined(SIMPLENET_HAS_BITPACK_SIMD)
+        typedef uint32_t bitpack_u32x4 __attribute__((vector_size(16)));
+        typedef uint32_t bitpack_u32x8 __attribute__((vector_size(32)));
+        typedef uint64_t bitpack_u64x2 __attribute__((vector_size(16)));
+        typedef uint64_t bitpack_u64x4 __attribute__((vector_size(32)));
+
+        template <typename Word>
+        struct bitpack_vectors;
+
+        template <>
+        struct bitpack_vectors<uint32_t> {
+            using sse = bitpack_u32x4;
+            using avx2 = bitpack_u32x8;
+        };
+
+        template <>
+        struct bitpack_vectors<uint64_t> {
+            using sse = bitpack_u64x2;
+            using avx2 = bitpack_u64x4;
+        };
+
+        template <typename Word>
+        __attribute__((target("sse4.1")))
+        std::size_t bitpack_encode_block_sse4(const Word* pIn, Word* pPrev, uint8_t* pOut) {
+            return bitpack_encode_block<Word, typename bitpack_vectors<Word>::sse>(pIn, pPrev, pOut);
+        }
+
+        template <typename Word>
+        __attribute__((target("sse4.1")))
+        void bitpack_decode_block_sse4(const uint8_t* pIn, unsigned nBits, Word* pOut, Word* pPrev) {
+            bitpack_decode_block<Word, typename bitpack_vectors<Word>::sse>(pIn, nBits, pOut, pPrev);
+        }
+
+        template <typename Word>
+        __attribute__((target("avx2")))
+        std::size_t bitpack_encode_block_avx2(const Word* pIn, Word* pPrev, uint8_t* pOut) {
+            return bitpack_encode_block<Word, typename bitpack_vectors<Word>::avx2>(pIn, pPrev, pOut);
+        }
+
+        template <typename Word>
+        __attribute__((target("avx2")))
+        void bitpack_decode_block_avx2(const uint8_t* pIn, unsigned nBits, Word* pOut, Word* pPrev) {
+            bitpack_decode_block<Word, typename bitpack_vectors<Word>::avx2>(pIn, nBits, pOut, pPrev);
+        }
+#endif
+
+    }
+
+    template <typename Word>
+    bitpack_kernels<Word> bitpack_scalar_kernels() {
+        return { &detail::bitpack_encode_block_scalar<Word>, &detail::bitpack_decode_block_scalar<Word>, "scalar" };
+    }
+
+    template <typename Word>
+    const bitpack_kernels<Word>& bitpack_best_kernels() {
+        static const bitpack_kernels<Word> kernels = []() -> bitpack_kernels<Word> {
+#if defined(SIMPLENET_HAS_BITPACK_SIMD)
+            if (__builtin_cpu_supports("avx2")) {
+                return { &detail::bitpack_encode_block_avx2<Word>, &detail::bitpack_decode_block_avx2<Word>, "avx2" };
+            }
+            if (__builtin_cpu_supports("sse4.1")) {
+                return { &detail::bitpack_encode_block_sse4<Word>, &detail::bitpack_decode_block_sse4<Word>, "sse4.1" };
+            }
+#endif
+            return bitpack_scalar_kernels<Word>();
+        }();
+        return kernels;
+    }
+
+    template <typename Word>
+    std::size_t bitpack_bound(std::size_t nCount) {
+        constexpr std::size_t nWordBits = sizeof(Word) * 8;
+        return (nCount / nBitpackBlockSize) * (1 + nWordBits * nBitpackRowBytes) + (nCount % nBitpackBlockSize) * ((nWordBits + 6) / 7);
+    }
+
+    template <typename Word>
+    uint8_t* bitpack_encode(uint8_t* pOut, const Word* pIn, std::size_t nCount, const bitpack_kernels<Word>& kernels = bitpack_best_kernels<Word>()) {
+        Word arrPrev[nBitpackRowBytes / sizeof(Word)] = {};
+        std::size_t i = 0;
+        for (; i + nBitpackBlockSize <= nCount; i += nBitpackBlockSize) {
+            pOut += kernels.encode(pIn + i, arrPrev, pOut);
+        }
+        Word nPrev = i > 0 ? pIn[i - 1] : 0;
+        for (; i < nCount; i++) {
+            pOut = varint_encode(pOut, detail::bitpack_zigzag_encode<Word>(Word(pIn[i] - nPrev)));
+            nPrev = pIn[i];
+        }
+        return pOut;
+    }
+
+    template <typename Word>
+    const uint8_t* bitpack_decode(const uint8_t* pIn, const uint8_t* pEnd, Word* pOut, std::size_t nCount, const bitpack_kernels<Word>& kernels = bitpack_best_kernels<Word>()) {
+        constexpr unsigned nWordBits = sizeof(Word) * 8;
+        Word arrPrev[nBitpackRowBytes / sizeof(Word)] = {};
+        std::size_t i = 0;
+        for (; i + nBitpackBlockSize <= nCount; i += nBitpackBlockSize) {
+            if (pIn == pEnd) {
+                return nullptr;
+            }
+            unsigned nBits = *pIn++;
+            if (nBits > nWordBits || std::size_t(pEnd - pIn) < nBits * nBitpackRowBytes) {
+                return nullptr;
+            }
+            kernels.decode(pIn, nBits, pOut + i, arrPrev);
+            pIn += nBits * nBitpackRowBytes;
+        }
+        Word nPrev = i > 0 ? pOut[i - 1] : 0;
+        for (; i < nCount; i++) {
+            uint64_t nWire = 0;
+            pIn = varint_decode(pIn, pEnd, nWire);
+            if (!pIn || nWire > std::numeric_limits<Word>::max()) {
+                return nullptr;
+            }
+            nPrev = Word(nPrev + detail::bitpack_zigzag_decode<Word>(Word(nWire)));
+            pOut[i] = nPrev;
+        }
+        return pIn;
+    }
+
+    template <typename Vector>
+    struct bitpacked {
+        using word_type = std::make_unsigned_t<typename std::remove_const_t<Vector>::value_type>;
+        static_assert(std::is_same<word_type, uint32_t>::value || std::is_same<word_type, uint64_t>::value, "Bit packing only handles vectors of 32 and 64 bit integers.\n");
+
+        explicit bitpacked(Vector& vec, std::size_t nMax = nBitpackMaxCount) : values(vec), nMaxCount(nMax) {
+        }
+
+        Vector& values;
+        std::size_t nMaxCount;
+    };
+
+}
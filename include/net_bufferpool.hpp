@@ -0,0 +1,142 @@
+#pragma once
+
+#include "net_common.hpp"
+
+namespace net {
+
+    class read_buffer_pool {
+    public:
+        read_buffer_pool([[maybe_unused]] asio::io_context& asioContext, std::size_t nBuffers, std::size_t nBufferSize) :
+            m_vecStorage(nBuffers * nBufferSize) {
+                for (std::size_t i = 0; i < nBuffers; i++) {
+                    m_vecBuffers.emplace_back(asio::buffer(m_vecStorage.data() + i * nBufferSize, nBufferSize));
+                    m_vecFree.push_back(nBuffers - 1 - i);
+                }
+#if defined(ASIO_HAS_IO_URING)
+                if (nBuffers > 0) {
+                    try {
+                        m_registration.emplace(asio::register_buffers(asioContext, m_vecBuffers));
+                    }
+                    catch (std::exception& e) {
+                        std::cerr << "[POOL] Buffer registration failed: " << e.what() << '\n';
+                    }
+                }
+#endif
+        }
+
+        read_buffer_pool(const read_buffer_pool&) = delete;
+        read_buffer_pool& operator=(const read_buffer_pool&) = delete;
+
+        std::optional<std::size_t> Acquire() {
+            std::scoped_lock lock(m_muxFree);
+            if (m_vecFree.empty()) {
+                return std::nullopt;
+            }
+            std::size_t nIndex = m_vecFree.back();
+            m_vecFree.pop_back();
+            return nIndex;
+        }
+
+        void Release(std::size_t nIndex) {
+            std::scoped_lock lock(m_muxFree);
+            m_vecFree.push_back(nIndex);
+        }
+
+        asio::mutable_buffer Buffer(std::size_t nIndex) const {
+            return m_vecBuffers[nIndex];
+        }
+
+        bool IsRegistered() const {
+#if defined(ASIO_HAS_IO_URING)
+            return m_registration.has_value();
+#else
+            return false;
+#endif
+        }
+
+#if defined(ASIO_HAS_IO_URING)
+        asio::mutable_registered_buffer RegisteredBuffer(std::size_t nIndex) {
+            return (*m_registration)[nIndex];
+        }
+#endif
+
+    private:
+        std::vector<uint8_t> m_vecStorage;
+        std::vector<asio::mutable_buffer> m_vecBuffers;
+        std::vector<std::size_t> m_vecFree;
+        std::mutex m_muxFree;
+#if defined(ASIO_HAS_IO_URING)
+        std::optional<asio::buffer_registration<std::vector<asio::mutable_buffer>>> m_registration;
+#endif
+    };
+
+    class body_pool {
+    public:
+        body_pool(std::size_t nMaxPooledSize = 1024 * 1024, std::size_t nMaxPerClass = 64) :
+            m_nMaxPooledSize(nMaxPooledSize), m_nMaxPerClass(nMaxPerClass) {
+                m_vecFree.resize(ClassIndex(nMaxPooledSize) + 1);
+        }
+
+        body_pool(const body_pool&) = delete;
+        body_pool& operator=(const body_pool&) = delete;
+
+        ~body_pool() {
+            for (auto& vecClass : m_vecFree) {
+                for (uint8_t* pBlock : vecClass) {
+                    delete[] pBlock;
+                }
+            }
+        }
+
+        std::pair<uint8_t*, std::size_t> Acquire(std::size_t nSize) {
+            if (nSize > m_nMaxPooledSize) {
+                return { new uint8_t[nSize], nSize };
+            }
+            std::size_t nClass = ClassIndex(nSize);
+            {
+                std::scoped_lock lock(m_muxFree);
+                if (!m_vecFree[nClass].empty()) {
+                    uint8_t* pBlock = m_vecFree[nClass].back();
+                    m_vecFree[nClass].pop_back();
+                    return { pBlock, ClassSize(nClass) };
+                }
+            }
+            return { new uint8_t[ClassSize(nClass)], ClassSize(nClass) };
+        }
+
+        void Release(uint8_t* pBlock, std::size_t nCapacity) {
+            if (nCapacity <= m_nMaxPooledSize) {
+                std::size_t nClass = ClassIndex(nCapacity);
+                if (ClassSize(nClass) == nCapacity) {
+                    std::scoped_lock lock(m_muxFree);
+                    if (m_vecFree[nClass].size() < m_nMaxPerClass) {
+                        m_vecFree[nClass].push_back(pBlock);
+                        return;
+                    }
+                }
+            }
+            delete[] pBlock;
+        }
+
+    private:
+        static constexpr std::size_t nMinClassSize = 256;
+
+        static std::size_t ClassIndex(std::size_t nSize) {
+            std::size_t nClass = 0;
+            while (ClassSize(nClass) < nSize) {
+                nClass++;
+            }
+            return nClass;
+        }
+
+        static std::size_t ClassSize(std::size_t nClass) {
+            return nMinClassSize << nClass;
+        }
+
+        std::size_t m_nMaxPooledSize;
+        std::size_t m_nMaxPerClass;
+        std::vector<std::vector<uint8_t*>> m_vecFree;
+        std::mutex m_muxFree;
+    };
+
+}
@@ -11,6 +11,9 @@ namespace net {
     class client_interface {
     public:
         client_interface() {
+#if defined(ASIO_HAS_IO_URING)
+            m_pReadPool = std::make_shared<read_buffer_pool>(m_asioContext, 1, 64 * 1024);
+#endif
         }
 
         virtual ~client_interface() {
@@ -21,8 +24,16 @@ namespace net {
             try {
                 asio::ip::tcp::resolver resolver(m_asioContext);
                 asio::ip::tcp::resolver::results_type endpoints = resolver.resolve(host, std::to_string(port));
-                m_connection = std::make_unique<connection<T>>(connection<T>::owner::client, m_asioContext, asio::ip::tcp::socket(m_asioContext), m_qMessagesIn);
-                m_connection->ConnectToServer(endpoints);
+                m_connection = std::make_shared<connection<T>>(connection<T>::owner::client, m_asioContext, asio::ip::tcp::socket(asio::make_strand(m_asioContext)), m_qMessagesIn);
+                m_connection->SetOutboundLimits(m_outboundLimits);
+                m_connection->SetReadBufferPool(m_pReadPool);
+                m_connection->SetBodyPool(m_pBodyPool);
+                m_connection->SetZeroCopyThreshold(m_nZeroCopyThreshold);
+                m_connection->SetCompressionThreshold(m_nCompressionThreshold);
+                m_connection->SetChecksumsEnabled(m_bChecksums);
+                m_connection->SetInboundLimits(m_inboundLimits);
+                m_connection->SetSocketOptions(m_socketOptions);
+                m_connection->ConnectToServer(endpoints, this);
                 m_thrContext = std::thread([this]() { m_asioContext.run(); });
                 return true;
             }
@@ -40,7 +51,7 @@ namespace net {
             if (m_thrContext.joinable()) {
                 m_thrContext.join();
             }
-            m_connection.release();
+            m_connection.reset();
         }
 
         bool IsConnected() const {
@@ -53,17 +64,77 @@ namespace net {
             }
         }
 
-        tsqueue<owned_message<T>>& Incoming() {
+        void Send(message<T>&& msg) const {
+            if (IsConnected()) {
+                m_connection->Send(std::move(msg));
+            }
+        }
+
+        void Send(message_batch<T>&& batch) const {
+            if (IsConnected()) {
+                m_connection->Send(std::move(batch));
+            }
+        }
+
+        void SetOutboundLimits(const outbound_limits& limits) {
+            m_outboundLimits = limits;
+        }
+
+        void SetInboundLimits(const inbound_limits& limits) {
+            m_inboundLimits = limits;
+        }
+
+        void SetSocketOptions(const socket_options& options) {
+            m_socketOptions = options;
+        }
+
+        void SetBodyPool(std::size_t nMaxPooledSize, std::size_t nMaxPerClass) {
+            m_pBodyPool = std::make_shared<body_pool>(nMaxPooledSize, nMaxPerClass);
+        }
+
+        void SetCompressionThreshold(std::size_t nBytes) {
+            m_nCompressionThreshold = nBytes;
+        }
+
+        compression_stats GetCompressionStats() const {
+            if (m_connection) {
+                return m_connection->GetCompressionStats();
+            }
+            return compression_stats();
+        }
+
+        void SetChecksumsEnabled(bool bEnabled) {
+            m_bChecksums = bEnabled;
+        }
+
+        void SetZeroCopyThreshold(std::size_t nBytes) {
+            m_nZeroCopyThreshold = nBytes;
+        }
+
+        incoming_queue<T>& Incoming() {
             return m_qMessagesIn;
         }
 
+        virtual std::shared_ptr<body_stream<T>> OnStreamBegin(const message_header<T>& header) {
+            return nullptr;
+        }
+
     protected:
         asio::io_context m_asioContext;
+        asio::executor_work_guard<asio::io_context::executor_type> m_idleWork = asio::make_work_guard(m_asioContext);
         std::thread m_thrContext;
-        std::unique_ptr<connection<T>> m_connection;
+        std::shared_ptr<connection<T>> m_connection;
 
     private:
-        tsqueue<owned_message<T>> m_qMessagesIn;
+        incoming_queue<T> m_qMessagesIn;
+        outbound_limits m_outboundLimits;
+        inbound_limits m_inboundLimits;
+        socket_options m_socketOptions;
+        std::shared_ptr<read_buffer_pool> m_pReadPool;
+        std::shared_ptr<body_pool> m_pBodyPool = std::make_shared<body_pool>();
+        std::size_t m_nZeroCopyThreshold = 0;
+        std::size_t m_nCompressionThreshold = 0;
+        bool m_bChecksums = false;
     };
 
 }
\ No newline at end of file
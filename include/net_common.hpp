@@ -5,6 +5,27 @@
 #include <chrono>
 #include <cstdint>
 #include <deque>
+#include <map>
+#include <limits>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+#if defined(__linux__)
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <linux/errqueue.h>
+#if defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+#define SIMPLENET_HAS_ZEROCOPY 1
+#endif
+#endif
 
 #define ASIO_STANDALONE
 #include <asio.hpp>
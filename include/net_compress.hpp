@@ -0,0 +1,159 @@
+#pragma once
+
+#include "net_common.hpp"
+
+namespace net {
+
+    inline std::size_t lz_compress_bound(std::size_t nSize) {
+        return nSize + nSize / 255 + 16;
+    }
+
+    namespace detail {
+
+        inline uint32_t lz_read32(const uint8_t* p) {
+            uint32_t nValue;
+            std::memcpy(&nValue, p, sizeof(nValue));
+            return nValue;
+        }
+
+        inline uint8_t* lz_write_length(uint8_t* pWrite, std::size_t nLength) {
+            while (nLength >= 255) {
+                *pWrite++ = 255;
+                nLength -= 255;
+            }
+            *pWrite++ = uint8_t(nLength);
+            return pWrite;
+        }
+
+        inline uint8_t* lz_write_sequence(uint8_t* pWrite, const uint8_t* pLiterals, std::size_t nLiterals, std::size_t nOffset, std::size_t nMatch) {
+            uint8_t* pToken = pWrite++;
+            *pToken = uint8_t(std::min<std::size_t>(nLiterals, 15) << 4);
+            if (nLiterals >= 15) {
+                pWrite = lz_write_length(pWrite, nLiterals - 15);
+            }
+            if (nLiterals > 0) {
+                std::memcpy(pWrite, pLiterals, nLiterals);
+                pWrite += nLiterals;
+            }
+            if (nMatch == 0) {
+                return pWrite;
+            }
+            *pWrite++ = uint8_t(nOffset);
+            *pWrite++ = uint8_t(nOffset >> 8);
+            nMatch -= 4;
+            *pToken |= uint8_t(std::min<std::size_t>(nMatch, 15));
+            if (nMatch >= 15) {
+                pWrite = lz_write_length(pWrite, nMatch - 15);
+            }
+            return pWrite;
+        }
+
+        inline bool lz_read_length(const uint8_t*& pRead, const uint8_t* pEnd, std::size_t& nLength) {
+            uint8_t nByte;
+            do {
+                if (pRead == pEnd) {
+                    return false;
+                }
+                nByte = *pRead++;
+                nLength += nByte;
+            } while (nByte == 255);
+            return true;
+        }
+
+    }
+
+    inline std::size_t lz_compress(const uint8_t* pSource, std::size_t nSize, uint8_t* pDestination, std::size_t nCapacity) {
+        constexpr std::size_t nHashBits = 12;
+        constexpr std::size_t nMinMatch = 4;
+        constexpr std::size_t nEndLiterals = 12;
+        constexpr std::size_t nMaxOffset = 65535;
+
+        if (nCapacity < lz_compress_bound(nSize)) {
+            return 0;
+        }
+
+        std::array<uint32_t, std::size_t(1) << nHashBits> arrTable{};
+        uint8_t* pWrite = pDestination;
+        std::size_t nAnchor = 0;
+        std::size_t nPos = 1;
+        std::size_t nLimit = nSize > nEndLiterals ? nSize - nEndLiterals : 0;
+
+        while (nPos < nLimit) {
+            uint32_t nSequence = detail::lz_read32(pSource + nPos);
+            std::size_t nHash = (nSequence * 2654435761u) >> (32 - nHashBits);
+            std::size_t nCandidate = arrTable[nHash];
+            arrTable[nHash] = uint32_t(nPos);
+            if (nCandidate < nPos && nPos - nCandidate <= nMaxOffset && detail::lz_read32(pSource + nCandidate) == nSequence) {
+                std::size_t nMatch = nMinMatch;
+                while (nPos + nMatch < nSize - 5 && pSource[nCandidate + nMatch] == pSource[nPos + nMatch]) {
+                    nMatch++;
+                }
+                pWrite = detail::lz_write_sequence(pWrite, pSource + nAnchor, nPos - nAnchor, nPos - nCandidate, nMatch);
+                nPos += nMatch;
+                nAnchor = nPos;
+            }
+            else {
+                nPos++;
+            }
+        }
+
+        pWrite = detail::lz_write_sequence(pWrite, pSource + nAnchor, nSize - nAnchor, 0, 0);
+        return std::size_t(pWrite - pDestination);
+    }
+
+    inline bool lz_decompress(const uint8_t* pSource, std::size_t nSize, uint8_t* pDestination, std::size_t nDecompressedSize) {
+        const uint8_t* pRead = pSource;
+        const uint8_t* pEnd = pSource + nSize;
+        uint8_t* pWrite = pDestination;
+        uint8_t* pWriteEnd = pDestination + nDecompressedSize;
+
+        while (pRead < pEnd) {
+            uint8_t nToken = *pRead++;
+            std::size_t nLiterals = nToken >> 4;
+            if (nLiterals == 15 && !detail::lz_read_length(pRead, pEnd, nLiterals)) {
+                return false;
+            }
+            if (nLiterals > std::size_t(pEnd - pRead) || nLiterals > std::size_t(pWriteEnd - pWrite)) {
+                return false;
+            }
+            if (nLiterals > 0) {
+                std::memcpy(pWrite, pRead, nLiterals);
+                pRead += nLiterals;
+                pWrite += nLiterals;
+            }
+            if (pRead == pEnd) {
+                break;
+            }
+
+            if (pEnd - pRead < 2) {
+                return false;
+            }
+            std::size_t nOffset = std::size_t(pRead[0]) | std::size_t(pRead[1]) << 8;
+            pRead += 2;
+            if (nOffset == 0 || nOffset > std::size_t(pWrite - pDestination)) {
+                return false;
+            }
+            std::size_t nMatch = nToken & 15;
+            if (nMatch == 15 && !detail::lz_read_length(pRead, pEnd, nMatch)) {
+                return false;
+            }
+            nMatch += 4;
+            if (nMatch > std::size_t(pWriteEnd - pWrite)) {
+                return false;
+            }
+            const uint8_t* pMatch = pWrite - nOffset;
+            if (nOffset >= nMatch) {
+                std::memcpy(pWrite, pMatch, nMatch);
+                pWrite += nMatch;
+            }
+            else {
+                for (std::size_t i = 0; i < nMatch; i++) {
+                    *pWrite++ = pMatch[i];
+                }
+            }
+        }
+
+        return pWrite == pWriteEnd;
+    }
+
+}
@@ -2,22 +2,101 @@
 
 #include "net_common.hpp"
 #include "net_tsqueue.hpp"
+#include "net_ringqueue.hpp"
+#include "net_allocator.hpp"
+#include "net_bufferpool.hpp"
+#include "net_socket.hpp"
 #include "net_message.hpp"
 
 namespace net {
 
     template <typename T>
     class server_interface;
+
+    template <typename T>
+    class client_interface;
+
+    enum class overflow_policy {
+        disconnect,
+        drop_oldest,
+        drop_newest,
+        block
+    };
+
+    struct outbound_limits {
+        std::size_t nMaxBytes = 0;
+        std::size_t nMaxMessages = 0;
+        std::size_t nHighWatermark = 16 * 1024 * 1024;
+        std::size_t nLowWatermark = 4 * 1024 * 1024;
+        overflow_policy policy = overflow_policy::disconnect;
+    };
     
+    struct inbound_limits {
+        std::size_t nMaxMessageSize = 64 * 1024 * 1024;
+        std::size_t nStreamThreshold = 1024 * 1024;
+        std::size_t nStreamChunkSize = 64 * 1024;
+        std::size_t nMaxBatchMessages = 16 * 1024;
+    };
+
+    struct compression_stats {
+        uint64_t nMessagesCompressed = 0;
+        uint64_t nBytesBeforeCompression = 0;
+        uint64_t nBytesAfterCompression = 0;
+        uint64_t nCompressNanoseconds = 0;
+        uint64_t nMessagesDecompressed = 0;
+        uint64_t nBytesBeforeDecompression = 0;
+        uint64_t nBytesAfterDecompression = 0;
+        uint64_t nDecompressNanoseconds = 0;
+
+        double send_ratio() const {
+            return nBytesAfterCompression > 0 ? double(nBytesBeforeCompression) / double(nBytesAfterCompression) : 1.0;
+        }
+
+        double receive_ratio() const {
+            return nBytesBeforeDecompression > 0 ? double(nBytesAfterDecompression) / double(nBytesBeforeDecompression) : 1.0;
+        }
+    };
+
+    template <typename T>
+    class body_stream {
+    public:
+        virtual ~body_stream() = default;
+
+        virtual asio::mutable_buffer Prepare(std::size_t nOffset, std::size_t nRemaining) {
+            return asio::mutable_buffer();
+        }
+
+        virtual void OnChunk(asio::const_buffer data, std::size_t nOffset) {
+        }
+
+        virtual void OnComplete(const message_header<T>& header, std::error_code ec) {
+        }
+    };
+
+    struct buffer_range {
+        const asio::const_buffer* pBegin;
+        const asio::const_buffer* pEnd;
+
+        const asio::const_buffer* begin() const {
+            return pBegin;
+        }
+
+        const asio::const_buffer* end() const {
+            return pEnd;
+        }
+    };
+
     template <typename T>
     class connection : public std::enable_shared_from_this<connection<T>> {
     public:
+        using framing = typename message_traits<T>::framing;
+
         enum class owner {
             server,
             client
         };
 
-        connection(owner parent, asio::io_context& asioContext, asio::ip::tcp::socket socket, tsqueue<owned_message<T>>& qIn) :
+        connection(owner parent, asio::io_context& asioContext, asio::ip::tcp::socket socket, incoming_queue<T>& qIn) :
             m_asioContext(asioContext), m_socket(std::move(socket)), m_qMessagesIn(qIn), m_nOwnerType(parent) {
                 if (m_nOwnerType == owner::server) {
                     m_nHandshakeOut = uint64_t(std::chrono::system_clock::now().time_since_epoch().count());
@@ -29,7 +108,9 @@ namespace net {
         }
 
         virtual ~connection() {
-            Disconnect();
+            if (m_pReadPool) {
+                m_pReadPool->Release(m_nReadSlot);
+            }
         }
 
         uint32_t GetID() {
@@ -40,29 +121,38 @@ namespace net {
             if (m_nOwnerType == owner::server) {
                 if (m_socket.is_open()) {
                     id = uid;
-                    WriteValidation();
-                    ReadValidation(server);
+                    m_pServer = server;
+                    asio::post(m_socket.get_executor(),
+                    BindAllocator([this, server]() {
+                        WriteValidation();
+                        ReadValidation(server);
+                    }));
                 }
             }
         }
 
-        void ConnectToServer(const asio::ip::tcp::resolver::results_type& endpoints) {
+        void ConnectToServer(const asio::ip::tcp::resolver::results_type& endpoints, client_interface<T>* client = nullptr) {
             if (m_nOwnerType == owner::client) {
-                asio::async_connect(m_socket, endpoints, 
-                [this](std::error_code ec, asio::ip::tcp::endpoint endpoint) {
+                m_pClient = client;
+                asio::async_connect(m_socket, endpoints,
+                BindAllocator([this](std::error_code ec, asio::ip::tcp::endpoint endpoint) {
                     if (!ec) {
+                        apply_socket_options(m_socket, m_socketOptions);
                         ReadValidation();
                     }
                     else {
                         std::cout << "Failed to connect to server: " << ec.message() << '\n';
                     }
-                });
+                }));
             }
         }
 
         void Disconnect() {
             if (IsConnected()) {
-                asio::post(m_asioContext, [this]() { m_socket.close(); });
+                asio::post(m_socket.get_executor(), BindAllocator([this]() {
+                    m_socket.close();
+                    WakeProducers();
+                }));
             }
         }
 
@@ -70,24 +160,218 @@ namespace net {
             return m_socket.is_open();
         }
 
+        void SetWriteBatchLimits(std::size_t nMaxBytes, std::size_t nMaxBuffers) {
+            asio::post(m_socket.get_executor(),
+            BindAllocator([this, nMaxBytes, nMaxBuffers]() {
+                m_nMaxWriteBytes = std::max<std::size_t>(nMaxBytes, 1);
+                m_nMaxWriteBuffers = std::max<std::size_t>(nMaxBuffers, 2);
+            }));
+        }
+
         void Send(const message<T>& msg) {
-            asio::post(m_asioContext, 
-            [this, msg]() {
-                bool bWritingMessage = !m_qMessagesOut.empty();
-                m_qMessagesOut.emplace_back(msg);
-                if (!bWritingMessage) {
-                    WriteHeader();
+            Send(message<T>(msg));
+        }
+
+        void Send(message<T>&& msg) {
+            Send(make_frame(std::move(msg)));
+        }
+
+        void Send(message_batch<T>&& batch) {
+            if (!batch.empty()) {
+                Send(make_frame(std::move(batch)));
+            }
+        }
+
+        void Send(shared_frame<T> frame, bool bWait = true) {
+            if (frame->msg().body.size() > framing::template max_body_size<T>()) {
+                std::cout << "[" << id << "] Message too large to frame (" << frame->msg().body.size() << " bytes), dropping.\n";
+                m_nDroppedMessages++;
+                return;
+            }
+            std::size_t nBytes = frame->size();
+            if (m_bBlockProducers && !m_asioContext.get_executor().running_in_this_thread()) {
+                std::unique_lock<std::mutex> ul(m_muxBlocking);
+                bool bReserved = TryReserve(nBytes);
+                if (!bReserved && bWait) {
+                    m_cvBlocking.wait(ul, [this, nBytes, &bReserved]() {
+                        bReserved = TryReserve(nBytes);
+                        return bReserved || !IsConnected();
+                    });
                 }
-            });
+                if (!bReserved) {
+                    m_nDroppedMessages++;
+                    return;
+                }
+            }
+            else {
+                m_nQueuedBytes += nBytes;
+                m_nQueuedMessages++;
+            }
+            asio::post(m_socket.get_executor(),
+            BindAllocator([this, frame = std::move(frame)]() mutable {
+                if (WouldOverflow(0, 0) && !MakeRoom()) {
+                    m_nQueuedBytes -= frame->size();
+                    m_nQueuedMessages--;
+                    m_nDroppedMessages++;
+                    return;
+                }
+                m_qMessagesOut.emplace_back(std::move(frame));
+                if (!m_bHighWatermark && m_limits.nHighWatermark > 0 && m_nQueuedBytes >= m_limits.nHighWatermark) {
+                    m_bHighWatermark = true;
+                    if (m_pServer) {
+                        m_pServer->OnClientHighWatermark(this->shared_from_this());
+                    }
+                }
+                if (m_bValidated && !m_bWriting) {
+                    WriteMessages();
+                }
+            }));
+        }
+
+        void SetReadBufferPool(std::shared_ptr<read_buffer_pool> pool) {
+            if (!m_pReadPool && pool) {
+                if (std::optional<std::size_t> slot = pool->Acquire()) {
+                    m_pReadPool = std::move(pool);
+                    m_nReadSlot = *slot;
+                    m_readBuffer = m_pReadPool->Buffer(m_nReadSlot);
+                }
+            }
+        }
+
+        void SetSocketOptions(const socket_options& options) {
+            asio::post(m_socket.get_executor(),
+            BindAllocator([this, options]() {
+                m_socketOptions = options;
+                if (m_socket.is_open()) {
+                    apply_socket_options(m_socket, m_socketOptions);
+                }
+            }));
+        }
+
+        void SetCompressionThreshold(std::size_t nBytes) {
+            m_nCompressionThreshold = nBytes;
+        }
+
+        void SetChecksumsEnabled(bool bEnabled) {
+            asio::post(m_socket.get_executor(),
+            BindAllocator([this, bEnabled]() {
+                uint32_t nCapabilities = bEnabled ? m_nCapabilitiesOut | nCapabilityChecksum : m_nCapabilitiesOut & ~nCapabilityChecksum;
+                if (nCapabilities == m_nCapabilitiesOut) {
+                    return;
+                }
+                if (m_bCapabilitiesSent) {
+                    std::cout << "[" << id << "] Checksums cannot change after the handshake, ignoring.\n";
+                    return;
+                }
+                m_nCapabilitiesOut = nCapabilities;
+            }));
+        }
+
+        compression_stats GetCompressionStats() {
+            std::scoped_lock lock(m_muxCompressionStats);
+            return m_compressionStats;
+        }
+
+        void SetZeroCopyThreshold(std::size_t nBytes) {
+            asio::post(m_socket.get_executor(),
+            BindAllocator([this, nBytes]() {
+                m_nZeroCopyThreshold = nBytes;
+            }));
+        }
+
+        std::size_t GetZeroCopyCopiedSends() const {
+            return m_nZeroCopyCopied;
+        }
+
+        void SetBodyPool(std::shared_ptr<body_pool> pool) {
+            m_pBodyPool = std::move(pool);
+        }
+
+        void SetInboundLimits(const inbound_limits& limits) {
+            m_inboundLimits = limits;
+        }
+
+        void SetOutboundLimits(const outbound_limits& limits) {
+            asio::post(m_socket.get_executor(),
+            BindAllocator([this, limits]() {
+                m_limits = limits;
+                m_nMaxQueuedBytes = limits.nMaxBytes;
+                m_nMaxQueuedMessages = limits.nMaxMessages;
+                m_bBlockProducers = limits.policy == overflow_policy::block;
+                WakeProducers();
+            }));
+        }
+
+        std::size_t GetQueuedBytes() const {
+            return m_nQueuedBytes;
+        }
+
+        std::size_t GetDroppedMessages() const {
+            return m_nDroppedMessages;
         }
 
     protected:
         owner m_nOwnerType = owner::server;
         asio::io_context& m_asioContext;
+        handler_memory m_handlerMemory;
         asio::ip::tcp::socket m_socket;
-        tsqueue<owned_message<T>>& m_qMessagesIn;
-        tsqueue<message<T>> m_qMessagesOut;
+        incoming_queue<T>& m_qMessagesIn;
+        ring_queue<shared_frame<T>> m_qMessagesOut;
+        std::vector<shared_frame<T>> m_vecMessagesWriting;
+        std::vector<asio::const_buffer> m_vecWriteBuffers;
+        std::size_t m_nMaxWriteBytes = 256 * 1024;
+        std::size_t m_nMaxWriteBuffers = 64;
+        bool m_bWriting = false;
+        bool m_bValidated = false;
+        std::size_t m_nWritingBytes = 0;
+        outbound_limits m_limits;
+        std::atomic<std::size_t> m_nQueuedBytes = 0;
+        std::atomic<std::size_t> m_nQueuedMessages = 0;
+        std::atomic<std::size_t> m_nDroppedMessages = 0;
+        std::atomic<std::size_t> m_nMaxQueuedBytes = 0;
+        std::atomic<std::size_t> m_nMaxQueuedMessages = 0;
+        std::atomic<bool> m_bBlockProducers = false;
+        bool m_bHighWatermark = false;
+        std::mutex m_muxBlocking;
+        std::condition_variable m_cvBlocking;
+        server_interface<T>* m_pServer = nullptr;
+        client_interface<T>* m_pClient = nullptr;
+        inbound_limits m_inboundLimits;
+        socket_options m_socketOptions;
+        std::shared_ptr<body_stream<T>> m_pStream;
+        message_header<T> m_streamHeader;
+        std::size_t m_nStreamOffset = 0;
+        std::size_t m_nStreamSize = 0;
+        std::vector<uint8_t> m_vecStreamChunk;
+        bool m_bStreamDeclined = false;
+        std::size_t m_nStreamTrailerSize = 0;
+        uint32_t m_nStreamChecksum = 0;
+        std::array<uint8_t, sizeof(uint32_t)> m_arrStreamTrailer{};
+        uint32_t m_nChecksumIn = 0;
+        std::size_t m_nZeroCopyThreshold = 0;
+        bool m_bWritingZeroCopy = false;
+#if defined(SIMPLENET_HAS_ZEROCOPY)
+        bool m_bZeroCopyEnabled = false;
+        bool m_bZeroCopyWaiting = false;
+        uint32_t m_nZeroCopyNextSend = 0;
+        std::deque<std::pair<uint32_t, shared_frame<T>>> m_deqZeroCopyPending;
+#endif
+        std::atomic<std::size_t> m_nZeroCopyCopied = 0;
         message<T> m_msgTemporaryIn;
+        std::vector<uint8_t> m_vecReadBuffer;
+        asio::mutable_buffer m_readBuffer;
+        std::shared_ptr<read_buffer_pool> m_pReadPool;
+        std::shared_ptr<body_pool> m_pBodyPool;
+        bool m_bCompressedIn = false;
+        bool m_bBatchIn = false;
+        std::vector<owned_message<T>> m_vecBatchIn;
+        decltype(message<T>::body) m_compressedIn;
+        std::atomic<std::size_t> m_nCompressionThreshold{0};
+        compression_stats m_compressionStats;
+        std::mutex m_muxCompressionStats;
+        std::size_t m_nReadSlot = 0;
+        std::size_t m_nReadStart = 0;
+        std::size_t m_nReadEnd = 0;
         uint32_t id = 0;
 
     private:
@@ -95,85 +379,611 @@ namespace net {
         uint64_t m_nHandshakeIn = 0;
         uint64_t m_nHandshakeCheck = 0;
 
-        void ReadHeader() {
-            asio::async_read(m_socket, asio::buffer(&m_msgTemporaryIn.header, sizeof(message_header<T>)), 
-            [this](std::error_code ec, std::size_t length) {
+        static constexpr uint32_t nCapabilityCompression = 1;
+        static constexpr uint32_t nCapabilityChecksum = 2;
+        static constexpr std::size_t nChecksumSize = sizeof(uint32_t);
+        uint32_t m_nCapabilitiesOut = framing::bHasFlags ? nCapabilityCompression : 0;
+        uint32_t m_nCapabilitiesIn = 0;
+        uint32_t m_nCapabilities = 0;
+        bool m_bCapabilitiesSent = false;
+
+        void ReadData() {
+            if (m_readBuffer.size() == 0) {
+                m_vecReadBuffer.resize(16 * 1024);
+                m_readBuffer = asio::buffer(m_vecReadBuffer);
+            }
+            uint8_t* pReadBuffer = static_cast<uint8_t*>(m_readBuffer.data());
+            if (m_nReadStart > 0) {
+                std::memmove(pReadBuffer, pReadBuffer + m_nReadStart, m_nReadEnd - m_nReadStart);
+                m_nReadEnd -= m_nReadStart;
+                m_nReadStart = 0;
+            }
+            auto handler = [this](std::error_code ec, std::size_t length) {
                 if (!ec) {
-                    if (m_msgTemporaryIn.header.size > sizeof(message_header<T>)) {
-                        m_msgTemporaryIn.body.resize(m_msgTemporaryIn.header.size - sizeof(message_header<T>));
-                        ReadBody();
-                    }
-                    else {
-                        AddToIncomingMessagesQueue();
+#if defined(__linux__)
+                    if (m_socketOptions.bQuickAck.value_or(false)) {
+                        int nEnable = 1;
+                        ::setsockopt(m_socket.native_handle(), IPPROTO_TCP, TCP_QUICKACK, &nEnable, sizeof(nEnable));
                     }
+#endif
+                    m_nReadEnd += length;
+                    ProcessReadBuffer();
                 }
                 else {
-                    std::cout << "[" << id << "] Read header failed: " << ec.message() <<  '\n';
+                    std::cout << "[" << id << "] Read failed: " << ec.message() <<  '\n';
                     m_socket.close();
+                    WakeProducers();
                 }
-            });
+            };
+#if defined(ASIO_HAS_IO_URING)
+            if (m_pReadPool && m_pReadPool->IsRegistered()) {
+                m_socket.async_read_some(m_pReadPool->RegisteredBuffer(m_nReadSlot) + m_nReadEnd, BindAllocator(std::move(handler)));
+                return;
+            }
+#endif
+            m_socket.async_read_some(m_readBuffer + m_nReadEnd, BindAllocator(std::move(handler)));
+        }
+
+        void ProcessReadBuffer() {
+            while (m_nReadEnd > m_nReadStart) {
+                const uint8_t* pFrame = static_cast<const uint8_t*>(m_readBuffer.data()) + m_nReadStart;
+                message_header<T> header;
+                std::size_t nBodySize = 0;
+                uint8_t nFlags = 0;
+                std::size_t nHeaderSize = framing::decode(pFrame, m_nReadEnd - m_nReadStart, header, nBodySize, nFlags);
+                if (nHeaderSize == nFrameIncomplete) {
+                    break;
+                }
+                if (nHeaderSize == nFrameMalformed) {
+                    std::cout << "[" << id << "] Malformed message header, disconnecting.\n";
+                    m_socket.close();
+                    return;
+                }
+                m_bCompressedIn = (nFlags & nFrameFlagCompressed) != 0;
+                m_bBatchIn = (nFlags & nFrameFlagBatch) != 0;
+                if (m_bCompressedIn && (m_nCapabilities & nCapabilityCompression) == 0) {
+                    std::cout << "[" << id << "] Unexpected compressed message, disconnecting.\n";
+                    m_socket.close();
+                    return;
+                }
+                std::size_t nAvailable = m_nReadEnd - m_nReadStart - nHeaderSize;
+                if (!m_bStreamDeclined && !m_bCompressedIn && !m_bBatchIn && m_inboundLimits.nStreamThreshold > 0 && nBodySize >= m_inboundLimits.nStreamThreshold) {
+                    m_pStream = OpenStream(header);
+                    m_bStreamDeclined = !m_pStream;
+                }
+                std::size_t nTrailerSize = ChecksumSize();
+                if (m_pStream) {
+                    m_streamHeader = header;
+                    m_nStreamSize = nBodySize;
+                    m_nStreamTrailerSize = nTrailerSize;
+                    m_nStreamOffset = 0;
+                    m_nStreamChecksum = nTrailerSize > 0 ? crc32c(0, pFrame, nHeaderSize) : 0;
+                    std::size_t nStreamBytes = std::min(nAvailable, nBodySize + nTrailerSize);
+                    ConsumeStream(pFrame + nHeaderSize, nStreamBytes);
+                    m_nReadStart += nHeaderSize + nStreamBytes;
+                    if (m_nStreamOffset == m_nStreamSize + m_nStreamTrailerSize) {
+                        if (!FinishStream()) {
+                            return;
+                        }
+                        continue;
+                    }
+                    m_nReadStart = m_nReadEnd = 0;
+                    ReadStream();
+                    return;
+                }
+                if (nBodySize > m_inboundLimits.nMaxMessageSize) {
+                    std::cout << "[" << id << "] Message too large (" << nBodySize << " bytes), disconnecting.\n";
+                    m_socket.close();
+                    return;
+                }
+                if (nAvailable >= nBodySize + nTrailerSize) {
+                    if (nTrailerSize > 0 && !ChecksumMatches(crc32c(0, pFrame, nHeaderSize + nBodySize), pFrame + nHeaderSize + nBodySize)) {
+                        std::cout << "[" << id << "] Checksum mismatch, disconnecting.\n";
+                        m_socket.close();
+                        return;
+                    }
+                    m_msgTemporaryIn.header = header;
+                    PrepareBody(nBodySize);
+                    std::memcpy(m_msgTemporaryIn.body.data(), pFrame + nHeaderSize, nBodySize);
+                    m_nReadStart += nHeaderSize + nBodySize + nTrailerSize;
+                    m_bStreamDeclined = false;
+                    if (!AddToIncomingMessagesQueue()) {
+                        return;
+                    }
+                }
+                else if (nHeaderSize + nBodySize + nTrailerSize > m_readBuffer.size()) {
+                    m_nChecksumIn = nTrailerSize > 0 ? crc32c(0, pFrame, nHeaderSize) : 0;
+                    m_msgTemporaryIn.header = header;
+                    PrepareBody(nBodySize + nTrailerSize);
+                    std::memcpy(m_msgTemporaryIn.body.data(), pFrame + nHeaderSize, nAvailable);
+                    m_nReadStart = m_nReadEnd = 0;
+                    m_bStreamDeclined = false;
+                    ReadBody(nAvailable);
+                    return;
+                }
+                else {
+                    break;
+                }
+            }
+            ReadData();
         }
 
-        void ReadBody() {
-            asio::async_read(m_socket, asio::buffer(m_msgTemporaryIn.body.data(), m_msgTemporaryIn.header.size - sizeof(message_header<T>)), 
-            [this](std::error_code ec, std::size_t length){
+        void ReadBody(std::size_t nOffset) {
+            asio::async_read(m_socket, asio::buffer(m_msgTemporaryIn.body.data() + nOffset, m_msgTemporaryIn.body.size() - nOffset),
+            BindAllocator([this](std::error_code ec, std::size_t length) {
                 if (!ec) {
-                    AddToIncomingMessagesQueue();
+                    if (!VerifyBodyChecksum()) {
+                        std::cout << "[" << id << "] Checksum mismatch, disconnecting.\n";
+                        m_socket.close();
+                        return;
+                    }
+                    if (AddToIncomingMessagesQueue()) {
+                        ReadData();
+                    }
                 }
                 else {
                     std::cout << "[" << id << "] Read body failed.\n";
                     m_socket.close();
                 }
-            });
+            }));
         }
 
-        void AddToIncomingMessagesQueue() {
-            if (m_nOwnerType == owner::server) {
-                m_qMessagesIn.emplace_back({this->shared_from_this(), m_msgTemporaryIn});
+        std::shared_ptr<body_stream<T>> OpenStream(const message_header<T>& header) {
+            if (m_pServer) {
+                return m_pServer->OnStreamBegin(this->shared_from_this(), header);
+            }
+            if (m_pClient) {
+                return m_pClient->OnStreamBegin(header);
+            }
+            return nullptr;
+        }
+
+        void DeliverChunk(const uint8_t* pData, std::size_t nSize, std::size_t nOffset) {
+            asio::mutable_buffer destination = m_pStream->Prepare(nOffset, m_nStreamSize - nOffset);
+            if (destination.size() > 0) {
+                std::size_t nCopied = std::min(nSize, destination.size());
+                std::memcpy(destination.data(), pData, nCopied);
+                m_pStream->OnChunk(asio::const_buffer(destination.data(), nCopied), nOffset);
+                if (nCopied < nSize) {
+                    DeliverChunk(pData + nCopied, nSize - nCopied, nOffset + nCopied);
+                }
             }
             else {
-                m_qMessagesIn.emplace_back({nullptr, m_msgTemporaryIn});
+                m_pStream->OnChunk(asio::const_buffer(pData, nSize), nOffset);
             }
-            ReadHeader();
         }
 
-        void WriteHeader() {
-            asio::async_write(m_socket, asio::buffer(&m_qMessagesOut.front().header, sizeof(message_header<T>)),
-            [this](std::error_code ec, std::size_t length) {
+        std::size_t ChecksumSize() const {
+            return (m_nCapabilities & nCapabilityChecksum) ? nChecksumSize : 0;
+        }
+
+        static bool ChecksumMatches(uint32_t nChecksum, const uint8_t* pTrailer) {
+            uint32_t nExpected;
+            std::memcpy(&nExpected, pTrailer, sizeof(nExpected));
+            return nChecksum == nExpected;
+        }
+
+        bool VerifyBodyChecksum() {
+            if (ChecksumSize() == 0) {
+                return true;
+            }
+            std::size_t nBodySize = m_msgTemporaryIn.body.size() - nChecksumSize;
+            bool bMatches = ChecksumMatches(crc32c(m_nChecksumIn, m_msgTemporaryIn.body.data(), nBodySize), m_msgTemporaryIn.body.data() + nBodySize);
+            m_msgTemporaryIn.body.resize(nBodySize);
+            return bMatches;
+        }
+
+        void ConsumeStream(const uint8_t* pData, std::size_t nSize) {
+            std::size_t nBody = m_nStreamOffset < m_nStreamSize ? std::min(nSize, m_nStreamSize - m_nStreamOffset) : 0;
+            if (nBody > 0) {
+                DeliverChunk(pData, nBody, m_nStreamOffset);
+                if (m_nStreamTrailerSize > 0) {
+                    m_nStreamChecksum = crc32c(m_nStreamChecksum, pData, nBody);
+                }
+            }
+            if (nSize > nBody) {
+                std::memcpy(m_arrStreamTrailer.data() + (m_nStreamOffset + nBody - m_nStreamSize), pData + nBody, nSize - nBody);
+            }
+            m_nStreamOffset += nSize;
+        }
+
+        bool FinishStream() {
+            if (m_nStreamTrailerSize > 0 && !ChecksumMatches(m_nStreamChecksum, m_arrStreamTrailer.data())) {
+                std::cout << "[" << id << "] Checksum mismatch, disconnecting.\n";
+                CloseStream(std::make_error_code(std::errc::illegal_byte_sequence));
+                m_socket.close();
+                return false;
+            }
+            CloseStream(std::error_code());
+            return true;
+        }
+
+        void CloseStream(std::error_code ec) {
+            std::shared_ptr<body_stream<T>> pStream = std::move(m_pStream);
+            pStream->OnComplete(m_streamHeader, ec);
+        }
+
+        void ReadStream() {
+            bool bTrailer = m_nStreamOffset >= m_nStreamSize;
+            asio::mutable_buffer destination;
+            if (bTrailer) {
+                std::size_t nTrailerOffset = m_nStreamOffset - m_nStreamSize;
+                destination = asio::buffer(m_arrStreamTrailer.data() + nTrailerOffset, m_nStreamTrailerSize - nTrailerOffset);
+            }
+            else {
+                std::size_t nRemaining = m_nStreamSize - m_nStreamOffset;
+                destination = m_pStream->Prepare(m_nStreamOffset, nRemaining);
+                if (destination.size() == 0) {
+                    m_vecStreamChunk.resize(std::max<std::size_t>(m_inboundLimits.nStreamChunkSize, 1));
+                    destination = asio::buffer(m_vecStreamChunk);
+                }
+                destination = asio::buffer(destination, nRemaining);
+            }
+            m_socket.async_read_some(destination,
+            BindAllocator([this, destination, bTrailer](std::error_code ec, std::size_t length) {
                 if (!ec) {
-                    if (m_qMessagesOut.front().body.size() > 0) {
-                        WriteBody();
-                    }
-                    else {
-                        m_qMessagesOut.pop_front();
-                        if (!m_qMessagesOut.empty()) {
-                            WriteHeader();
+                    if (!bTrailer) {
+                        m_pStream->OnChunk(asio::const_buffer(destination.data(), length), m_nStreamOffset);
+                        if (m_nStreamTrailerSize > 0) {
+                            m_nStreamChecksum = crc32c(m_nStreamChecksum, destination.data(), length);
                         }
                     }
+                    m_nStreamOffset += length;
+                    if (m_nStreamOffset < m_nStreamSize + m_nStreamTrailerSize) {
+                        ReadStream();
+                    }
+                    else if (FinishStream()) {
+                        ReadData();
+                    }
                 }
                 else {
-                    std::cout << "[" << id << "] Write header failed: " << ec.message() << '\n';
+                    std::cout << "[" << id << "] Read stream failed: " << ec.message() << '\n';
+                    CloseStream(ec);
                     m_socket.close();
                 }
-            });
+            }));
+        }
+
+        void PrepareBody(std::size_t nBodySize) {
+            if (nBodySize > m_msgTemporaryIn.body.capacity()) {
+                m_msgTemporaryIn.body.set_pool(m_pBodyPool);
+            }
+            m_msgTemporaryIn.body.resize(nBodySize);
+        }
+
+        bool AddToIncomingMessagesQueue() {
+            if (m_bCompressedIn && !DecompressIncoming()) {
+                std::cout << "[" << id << "] Decompression failed, disconnecting.\n";
+                m_socket.close();
+                return false;
+            }
+            if (m_bBatchIn) {
+                if (!UnpackBatch()) {
+                    m_socket.close();
+                    return false;
+                }
+                return true;
+            }
+            if (m_nOwnerType == owner::server) {
+                m_qMessagesIn.emplace_back({this->shared_from_this(), std::move(m_msgTemporaryIn)});
+            }
+            else {
+                m_qMessagesIn.emplace_back({nullptr, std::move(m_msgTemporaryIn)});
+            }
+            return true;
+        }
+
+        bool UnpackBatch() {
+            std::shared_ptr<connection<T>> remote = m_nOwnerType == owner::server ? this->shared_from_this() : nullptr;
+            const uint8_t* pRead = m_msgTemporaryIn.body.data();
+            const uint8_t* pEnd = pRead + m_msgTemporaryIn.body.size();
+            m_vecBatchIn.clear();
+            while (pRead < pEnd) {
+                if (m_inboundLimits.nMaxBatchMessages > 0 && m_vecBatchIn.size() == m_inboundLimits.nMaxBatchMessages) {
+                    std::cout << "[" << id << "] Message batch holds more than " << m_inboundLimits.nMaxBatchMessages << " messages, disconnecting.\n";
+                    m_vecBatchIn.clear();
+                    return false;
+                }
+                message<T> msg;
+                std::size_t nBodySize = 0;
+                uint8_t nFlags = 0;
+                std::size_t nHeaderSize = compact_framing::decode(pRead, std::size_t(pEnd - pRead), msg.header, nBodySize, nFlags);
+                if (nHeaderSize == nFrameIncomplete || nHeaderSize == nFrameMalformed || nFlags != 0 || nBodySize > std::size_t(pEnd - pRead) - nHeaderSize) {
+                    std::cout << "[" << id << "] Malformed message batch, disconnecting.\n";
+                    m_vecBatchIn.clear();
+                    return false;
+                }
+                pRead += nHeaderSize;
+                if (nBodySize > msg.body.capacity()) {
+                    msg.body.set_pool(m_pBodyPool);
+                }
+                if (nBodySize > 0) {
+                    msg.body.assign(pRead, nBodySize);
+                }
+                pRead += nBodySize;
+                m_vecBatchIn.push_back({remote, std::move(msg)});
+            }
+            m_qMessagesIn.emplace_back_bulk(m_vecBatchIn);
+            return true;
         }
 
-        void WriteBody() {
-            asio::async_write(m_socket, asio::buffer(m_qMessagesOut.front().body.data(), m_qMessagesOut.front().body.size()),
-            [this](std::error_code ec, std::size_t length) {
+        bool DecompressIncoming() {
+            auto tStart = std::chrono::steady_clock::now();
+            std::swap(m_msgTemporaryIn.body, m_compressedIn);
+            const uint8_t* pEnd = m_compressedIn.data() + m_compressedIn.size();
+            uint64_t nBodySize = 0;
+            const uint8_t* pPayload = varint_decode(m_compressedIn.data(), pEnd, nBodySize);
+            if (!pPayload || nBodySize > m_inboundLimits.nMaxMessageSize) {
+                return false;
+            }
+            PrepareBody(std::size_t(nBodySize));
+            if (!lz_decompress(pPayload, std::size_t(pEnd - pPayload), m_msgTemporaryIn.body.data(), std::size_t(nBodySize))) {
+                return false;
+            }
+            m_msgTemporaryIn.header.size = uint32_t(m_msgTemporaryIn.size());
+            std::scoped_lock lock(m_muxCompressionStats);
+            m_compressionStats.nMessagesDecompressed++;
+            m_compressionStats.nBytesBeforeDecompression += m_compressedIn.size();
+            m_compressionStats.nBytesAfterDecompression += nBodySize;
+            m_compressionStats.nDecompressNanoseconds += uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - tStart).count());
+            return true;
+        }
+
+        void WriteMessages() {
+            m_vecMessagesWriting.clear();
+            m_vecWriteBuffers.clear();
+            std::size_t nBytes = 0;
+            std::size_t nWireBytes = 0;
+            std::size_t nBuffers = 0;
+            m_bWritingZeroCopy = false;
+            bool bChecksum = ChecksumSize() > 0;
+            while (!m_qMessagesOut.empty()) {
+                const message_frame<T>& frame = *m_qMessagesOut.front();
+                bool bCompressed = UseCompression(frame);
+                if (!bCompressed && UseZeroCopy(frame)) {
+                    if (!m_vecMessagesWriting.empty()) {
+                        break;
+                    }
+                    m_bWritingZeroCopy = true;
+                }
+                std::size_t nFrameBytes = frame.size() + (bChecksum ? nChecksumSize : 0);
+                if (!m_vecMessagesWriting.empty() && (nWireBytes + nFrameBytes > m_nMaxWriteBytes || nBuffers + frame.buffer_count(bCompressed) + (bChecksum ? 1 : 0) > m_nMaxWriteBuffers)) {
+                    break;
+                }
+                nBytes += frame.size();
+                nWireBytes += nFrameBytes;
+                nBuffers += frame.buffer_count(bCompressed) + (bChecksum ? 1 : 0);
+                frame.append_buffers(m_vecWriteBuffers, bCompressed);
+                if (bChecksum) {
+                    m_vecWriteBuffers.emplace_back(asio::buffer(&frame.checksum(bCompressed), nChecksumSize));
+                }
+                if (bCompressed) {
+                    CountCompressed(frame);
+                }
+                m_vecMessagesWriting.emplace_back(m_qMessagesOut.pop_front());
+                if (m_bWritingZeroCopy) {
+                    break;
+                }
+            }
+            m_nWritingBytes = nBytes;
+            m_bWriting = true;
+            WriteBuffers();
+        }
+
+        void WriteBuffers() {
+            asio::socket_base::message_flags nFlags = 0;
+#if defined(SIMPLENET_HAS_ZEROCOPY)
+            if (m_bWritingZeroCopy) {
+                nFlags = MSG_ZEROCOPY;
+            }
+#endif
+            m_socket.async_send(buffer_range{m_vecWriteBuffers.data(), m_vecWriteBuffers.data() + m_vecWriteBuffers.size()}, nFlags,
+            BindAllocator([this](std::error_code ec, std::size_t length) {
                 if (!ec) {
-                    m_qMessagesOut.pop_front();
+#if defined(SIMPLENET_HAS_ZEROCOPY)
+                    if (m_bWritingZeroCopy && length > 0) {
+                        m_deqZeroCopyPending.emplace_back(m_nZeroCopyNextSend++, m_vecMessagesWriting.front());
+                        DrainZeroCopyCompletions();
+                    }
+#endif
+                    std::size_t nConsumed = 0;
+                    while (nConsumed < m_vecWriteBuffers.size() && length >= m_vecWriteBuffers[nConsumed].size()) {
+                        length -= m_vecWriteBuffers[nConsumed].size();
+                        nConsumed++;
+                    }
+                    m_vecWriteBuffers.erase(m_vecWriteBuffers.begin(), m_vecWriteBuffers.begin() + nConsumed);
+                    if (!m_vecWriteBuffers.empty()) {
+                        m_vecWriteBuffers.front() += length;
+                        WriteBuffers();
+                        return;
+                    }
+                    ReleaseWritten();
                     if (!m_qMessagesOut.empty()) {
-                        WriteHeader();
+                        WriteMessages();
+                    }
+                    else {
+                        m_bWriting = false;
                     }
                 }
                 else {
-                    std::cout << "[" << id << "] Write body failed.\n";
+                    std::cout << "[" << id << "] Write message failed: " << ec.message() << '\n';
                     m_socket.close();
+                    WakeProducers();
+                }
+            }));
+        }
+
+        bool UseCompression(const message_frame<T>& frame) {
+            std::size_t nThreshold = m_nCompressionThreshold;
+            if ((m_nCapabilities & nCapabilityCompression) == 0 || nThreshold == 0 || frame.msg().body.size() < nThreshold) {
+                return false;
+            }
+            uint64_t nNanoseconds = 0;
+            bool bCompressed = frame.compress(nNanoseconds);
+            if (nNanoseconds > 0) {
+                std::scoped_lock lock(m_muxCompressionStats);
+                m_compressionStats.nCompressNanoseconds += nNanoseconds;
+            }
+            return bCompressed;
+        }
+
+        void CountCompressed(const message_frame<T>& frame) {
+            std::scoped_lock lock(m_muxCompressionStats);
+            m_compressionStats.nMessagesCompressed++;
+            m_compressionStats.nBytesBeforeCompression += frame.msg().body.size();
+            m_compressionStats.nBytesAfterCompression += frame.compressed_size();
+        }
+
+        bool UseZeroCopy(const message_frame<T>& frame) {
+#if defined(SIMPLENET_HAS_ZEROCOPY)
+            if (m_nZeroCopyThreshold == 0 || frame.msg().body.size() < m_nZeroCopyThreshold) {
+                return false;
+            }
+            if (!m_bZeroCopyEnabled) {
+                int nEnable = 1;
+                if (::setsockopt(m_socket.native_handle(), SOL_SOCKET, SO_ZEROCOPY, &nEnable, sizeof(nEnable)) != 0) {
+                    std::cout << "[" << id << "] Zero-copy send unavailable, using regular writes.\n";
+                    m_nZeroCopyThreshold = 0;
+                    return false;
+                }
+                m_bZeroCopyEnabled = true;
+            }
+            return true;
+#else
+            return false;
+#endif
+        }
+
+#if defined(SIMPLENET_HAS_ZEROCOPY)
+        void DrainZeroCopyCompletions() {
+            ReadZeroCopyNotifications();
+            if (!m_deqZeroCopyPending.empty() && !m_bZeroCopyWaiting) {
+                m_bZeroCopyWaiting = true;
+                m_socket.async_wait(asio::socket_base::wait_error,
+                BindAllocator([this](std::error_code ec) {
+                    m_bZeroCopyWaiting = false;
+                    if (!ec) {
+                        DrainZeroCopyCompletions();
+                    }
+                }));
+                ReadZeroCopyNotifications();
+            }
+        }
+
+        void ReadZeroCopyNotifications() {
+            while (!m_deqZeroCopyPending.empty()) {
+                char aControl[CMSG_SPACE(sizeof(sock_extended_err)) + 64];
+                msghdr msg{};
+                msg.msg_control = aControl;
+                msg.msg_controllen = sizeof(aControl);
+                if (::recvmsg(m_socket.native_handle(), &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
+                    return;
                 }
+                for (cmsghdr* pCmsg = CMSG_FIRSTHDR(&msg); pCmsg != nullptr; pCmsg = CMSG_NXTHDR(&msg, pCmsg)) {
+                    if (!(pCmsg->cmsg_level == SOL_IP && pCmsg->cmsg_type == IP_RECVERR) &&
+                        !(pCmsg->cmsg_level == SOL_IPV6 && pCmsg->cmsg_type == IPV6_RECVERR)) {
+                        continue;
+                    }
+                    sock_extended_err err;
+                    std::memcpy(&err, CMSG_DATA(pCmsg), sizeof(err));
+                    if (err.ee_errno != 0 || err.ee_origin != SO_EE_ORIGIN_ZEROCOPY) {
+                        continue;
+                    }
+                    if (err.ee_code & SO_EE_CODE_ZEROCOPY_COPIED) {
+                        m_nZeroCopyCopied += err.ee_data - err.ee_info + 1;
+                    }
+                    while (!m_deqZeroCopyPending.empty() && int32_t(m_deqZeroCopyPending.front().first - err.ee_data) <= 0) {
+                        m_deqZeroCopyPending.pop_front();
+                    }
+                }
+            }
+        }
+#endif
+
+        template <typename Handler>
+        auto BindAllocator(Handler&& handler) {
+            return asio::bind_allocator(handler_allocator<int>(m_handlerMemory),
+            [self = this->shared_from_this(), handler = std::forward<Handler>(handler)](auto&&... args) mutable {
+                handler(std::forward<decltype(args)>(args)...);
             });
         }
 
+        bool WouldOverflow(std::size_t nBytes, std::size_t nMessages) const {
+            if (m_nQueuedMessages + nMessages <= 1) {
+                return false;
+            }
+            return (m_limits.nMaxBytes > 0 && m_nQueuedBytes + nBytes > m_limits.nMaxBytes) ||
+                (m_limits.nMaxMessages > 0 && m_nQueuedMessages + nMessages > m_limits.nMaxMessages);
+        }
+
+        bool TryReserve(std::size_t nBytes) {
+            std::size_t nMaxMessages = m_nMaxQueuedMessages;
+            std::size_t nMessages = m_nQueuedMessages;
+            do {
+                if (nMessages > 0 && nMaxMessages > 0 && nMessages >= nMaxMessages) {
+                    return false;
+                }
+            } while (!m_nQueuedMessages.compare_exchange_weak(nMessages, nMessages + 1));
+            std::size_t nMaxBytes = m_nMaxQueuedBytes;
+            std::size_t nQueued = m_nQueuedBytes;
+            do {
+                if (nMessages > 0 && nMaxBytes > 0 && nQueued + nBytes > nMaxBytes) {
+                    m_nQueuedMessages--;
+                    return false;
+                }
+            } while (!m_nQueuedBytes.compare_exchange_weak(nQueued, nQueued + nBytes));
+            return true;
+        }
+
+        void WakeProducers() {
+            std::scoped_lock lock(m_muxBlocking);
+            m_cvBlocking.notify_all();
+        }
+
+        bool MakeRoom() {
+            switch (m_limits.policy) {
+                case overflow_policy::disconnect: {
+                    if (m_socket.is_open()) {
+                        std::cout << "[" << id << "] Outbound queue limit reached, disconnecting.\n";
+                        m_socket.close();
+                    }
+                    WakeProducers();
+                    return false;
+                }
+                case overflow_policy::drop_oldest: {
+                    while (!m_qMessagesOut.empty() && WouldOverflow(0, 0)) {
+                        m_nQueuedBytes -= m_qMessagesOut.front()->size();
+                        m_nQueuedMessages--;
+                        m_nDroppedMessages++;
+                        m_qMessagesOut.pop_front();
+                    }
+                    return !WouldOverflow(0, 0);
+                }
+                case overflow_policy::drop_newest: {
+                    return false;
+                }
+                default: {
+                    return true;
+                }
+            }
+        }
+
+        void ReleaseWritten() {
+            m_nQueuedBytes -= m_nWritingBytes;
+            m_nQueuedMessages -= m_vecMessagesWriting.size();
+            m_nWritingBytes = 0;
+            m_vecMessagesWriting.clear();
+            if (m_bHighWatermark && m_nQueuedBytes <= m_limits.nLowWatermark) {
+                m_bHighWatermark = false;
+                if (m_pServer) {
+                    m_pServer->OnClientLowWatermark(this->shared_from_this());
+                }
+            }
+            if (m_limits.policy == overflow_policy::block) {
+                WakeProducers();
+            }
+        }
+
         uint64_t scramble(uint64_t nInput) {
             uint64_t out = nInput ^ 0xDEADBEEFC0DECAFE;
             out = (out & 0xF0F0F0F0F0F0F0) >> 4 | (out & 0x0F0F0F0F0F0F0F) << 4;
@@ -181,44 +991,68 @@ namespace net {
         }
 
         void WriteValidation() {
-            asio::async_write(m_socket, asio::buffer(&m_nHandshakeOut, sizeof(uint64_t)), 
-            [this](std::error_code ec, std::size_t length) {
+            m_bCapabilitiesSent = true;
+            std::array<asio::const_buffer, 2> arrHandshake = {
+                asio::buffer(&m_nHandshakeOut, sizeof(uint64_t)),
+                asio::buffer(&m_nCapabilitiesOut, sizeof(uint32_t))
+            };
+            asio::async_write(m_socket, arrHandshake, 
+            BindAllocator([this](std::error_code ec, std::size_t length) {
                 if (!ec) {
                     if (m_nOwnerType == owner::client) {
-                        ReadHeader();
+                        OnValidated();
+                        ReadData();
                     }
                 }
                 else {
                     m_socket.close();
+                    WakeProducers();
                 }
-            });
+            }));
+        }
+
+        void OnValidated() {
+            m_bValidated = true;
+            if (!m_bWriting && !m_qMessagesOut.empty()) {
+                WriteMessages();
+            }
         }
 
         void ReadValidation(server_interface<T>* server = nullptr) {
-            asio::async_read(m_socket, asio::buffer(&m_nHandshakeIn, sizeof(uint64_t)), 
-            [this, server](std::error_code ec, std::size_t length) {
+            std::array<asio::mutable_buffer, 2> arrHandshake = {
+                asio::buffer(&m_nHandshakeIn, sizeof(uint64_t)),
+                asio::buffer(&m_nCapabilitiesIn, sizeof(uint32_t))
+            };
+            asio::async_read(m_socket, arrHandshake, 
+            BindAllocator([this, server](std::error_code ec, std::size_t length) {
                 if (!ec) {
                     if (m_nOwnerType == owner::server) {
                         if (m_nHandshakeIn == m_nHandshakeCheck) {
+                            m_nCapabilities = m_nCapabilitiesOut & m_nCapabilitiesIn;
                             std::cout << "[" << id << "] Client validated.\n";
+                            OnValidated();
                             server->OnClientValidated(this->shared_from_this());
-                            ReadHeader();
+                            ReadData();
                         }
                         else {
                             std::cout << "[" << id << "] Client disconnected (validation failed).\n";
                             m_socket.close();
+                            WakeProducers();
                         }
                     }
                     else {
                         m_nHandshakeOut = scramble(m_nHandshakeIn);
+                        m_nCapabilitiesOut &= m_nCapabilitiesIn;
+                        m_nCapabilities = m_nCapabilitiesOut;
                         WriteValidation();
                     }
                 }
                 else {
                     std::cout << "Client disconnected (ReadValidation)\n";
                     m_socket.close();
+                    WakeProducers();
                 }
-            });
+            }));
         }
     };
 }
\ No newline at end of file
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "net_common.hpp"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <nmmintrin.h>
+#define SIMPLENET_HAS_CRC32C_SSE42 1
+#elif defined(__GNUC__) && defined(__aarch64__) && defined(__linux__)
+#include <arm_acle.h>
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#define SIMPLENET_HAS_CRC32C_ARMV8 1
+#endif
+
+namespace net {
+
+    namespace detail {
+
+        using crc32c_tables = std::array<std::array<uint32_t, 256>, 8>;
+
+        constexpr crc32c_tables make_crc32c_tables() {
+            crc32c_tables tables{};
+            for (uint32_t i = 0; i < 256; i++) {
+                uint32_t nCrc = i;
+                for (int j = 0; j < 8; j++) {
+                    nCrc = (nCrc >> 1) ^ (0x82F63B78u & (0u - (nCrc & 1u)));
+                }
+                tables[0][i] = nCrc;
+            }
+            for (std::size_t t = 1; t < 8; t++) {
+                for (std::size_t i = 0; i < 256; i++) {
+                    tables[t][i] = (tables[t - 1][i] >> 8) ^ tables[0][tables[t - 1][i] & 0xFF];
+                }
+            }
+            return tables;
+        }
+
+        inline constexpr crc32c_tables arrCrc32cTables = make_crc32c_tables();
+
+    }
+
+    inline uint32_t crc32c_table(uint32_t nCrc, const void* pData, std::size_t nSize) {
+        const auto& t = detail::arrCrc32cTables;
+        const uint8_t* p = static_cast<const uint8_t*>(pData);
+        nCrc = ~nCrc;
+        while (nSize >= 8) {
+            uint32_t nLow;
+            uint32_t nHigh;
+            std::memcpy(&nLow, p, sizeof(nLow));
+            std::memcpy(&nHigh, p + 4, sizeof(nHigh));
+            nLow ^= nCrc;
+            nCrc = t[7][nLow & 0xFF] ^ t[6][(nLow >> 8) & 0xFF] ^ t[5][(nLow >> 16) & 0xFF] ^ t[4][nLow >> 24] ^
+                   t[3][nHigh & 0xFF] ^ t[2][(nHigh >> 8) & 0xFF] ^ t[1][(nHigh >> 16) & 0xFF] ^ t[0][nHigh >> 24];
+            p += 8;
+            nSize -= 8;
+        }
+        while (nSize-- > 0) {
+            nCrc = (nCrc >> 8) ^ t[0][(nCrc ^ *p++) & 0xFF];
+        }
+        return ~nCrc;
+    }
+
+#if defined(SIMPLENET_HAS_CRC32C_SSE42)
+    __attribute__((target("sse4.2")))
+    inline uint32_t crc32c_hardware(uint32_t nCrc, const void* pData, std::size_t nSize) {
+        const uint8_t* p = static_cast<const uint8_t*>(pData);
+        nCrc = ~nCrc;
+#if defined(__x86_64__)
+        uint64_t nCrc64 = nCrc;
+        while (nSize >= 8) {
+            uint64_t nValue;
+            std::memcpy(&nValue, p, sizeof(nValue));
+            nCrc64 = _mm_crc32_u64(nCrc64, nValue);
+            p += 8;
+            nSize -= 8;
+        }
+        nCrc = uint32_t(nCrc64);
+#endif
+        while (nSize >= 4) {
+            uint32_t nValue;
+            std::memcpy(&nValue, p, sizeof(nValue));
+            nCrc = _mm_crc32_u32(nCrc, nValue);
+            p += 4;
+            nSize -= 4;
+        }
+        while (nSize-- > 0) {
+            nCrc = _mm_crc32_u8(nCrc, *p++);
+        }
+        return ~nCrc;
+    }
+
+    inline bool crc32c_hardware_available() {
+        return __builtin_cpu_supports("sse4.2");
+    }
+#elif defined(SIMPLENET_HAS_CRC32C_ARMV8)
+    __attribute__((target("+crc")))
+    inline uint32_t crc32c_hardware(uint32_t nCrc, const void* pData, std::size_t nSize) {
+        const uint8_t* p = static_cast<const uint8_t*>(pData);
+        nCrc = ~nCrc;
+        while (nSize >= 8) {
+            uint64_t nValue;
+            std::memcpy(&nValue, p, sizeof(nValue));
+            nCrc = __crc32cd(nCrc, nValue);
+            p += 8;
+            nSize -= 8;
+        }
+        while (nSize-- > 0) {
+            nCrc = __crc32cb(nCrc, *p++);
+        }
+        return ~nCrc;
+    }
+
+    inline bool crc32c_hardware_available() {
+        return (getauxval(AT_HWCAP) & HWCAP_CRC32) != 0;
+    }
+#else
+    inline uint32_t crc32c_hardware(uint32_t nCrc, const void* pData, std::size_t nSize) {
+        return crc32c_table(nCrc, pData, nSize);
+    }
+
+    inline bool crc32c_hardware_available() {
+        return false;
+    }
+#endif
+
+    inline uint32_t crc32c(uint32_t nCrc, const void* pData, std::size_t nSize) {
+        static const auto pImplementation = crc32c_hardware_available() ? &crc32c_hardware : &crc32c_table;
+        return pImplementation(nCrc, pData, nSize);
+    }
+
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "net_common.hpp"
+#include "net_varint.hpp"
+
+namespace net {
+
+    template <typename T>
+    struct message_header;
+
+    constexpr uint8_t nFrameFlagCompressed = 0x01;
+    constexpr uint8_t nFrameFlagBatch = 0x02;
+
+    constexpr std::size_t nFrameIncomplete = 0;
+    constexpr std::size_t nFrameMalformed = std::size_t(-1);
+
+    struct standard_framing {
+        static constexpr bool bHasFlags = false;
+
+        template <typename T>
+        static constexpr std::size_t max_header_size() {
+            return sizeof(message_header<T>);
+        }
+
+        template <typename T>
+        static constexpr uint64_t max_body_size() {
+            return std::numeric_limits<uint32_t>::max() - sizeof(message_header<T>);
+        }
+
+        template <typename T>
+        static std::size_t encode(const message_header<T>& header, std::size_t nBodySize, uint8_t nFlags, uint8_t* pWrite) {
+            message_header<T> wire = header;
+            wire.size = uint32_t(sizeof(message_header<T>) + nBodySize);
+            std::memcpy(pWrite, &wire, sizeof(message_header<T>));
+            return sizeof(message_header<T>);
+        }
+
+        template <typename T>
+        static std::size_t decode(const uint8_t* pRead, std::size_t nAvailable, message_header<T>& header, std::size_t& nBodySize, uint8_t& nFlags) {
+            if (nAvailable < sizeof(message_header<T>)) {
+                return nFrameIncomplete;
+            }
+            std::memcpy(&header, pRead, sizeof(message_header<T>));
+            nFlags = 0;
+            nBodySize = header.size > sizeof(message_header<T>) ? header.size - sizeof(message_header<T>) : 0;
+            return sizeof(message_header<T>);
+        }
+    };
+
+    struct compact_framing {
+        static constexpr bool bHasFlags = true;
+        static constexpr unsigned nFlagBits = 2;
+        static constexpr std::size_t nMaxVarintSize = 10;
+
+        template <typename T>
+        using id_type = std::make_unsigned_t<typename std::conditional_t<std::is_enum<T>::value, std::underlying_type<T>, std::common_type<T>>::type>;
+
+        template <typename T>
+        static constexpr std::size_t max_header_size() {
+            return 2 * nMaxVarintSize;
+        }
+
+        template <typename T>
+        static constexpr uint64_t max_body_size() {
+            return std::numeric_limits<uint64_t>::max() >> nFlagBits;
+        }
+
+        template <typename T>
+        static std::size_t encode(const message_header<T>& header, std::size_t nBodySize, uint8_t nFlags, uint8_t* pWrite) {
+            uint8_t* pEnd = varint_encode(pWrite, (uint64_t(nBodySize) << nFlagBits) | (nFlags & ((1u << nFlagBits) - 1)));
+            pEnd = varint_encode(pEnd, uint64_t(id_type<T>(header.id)));
+            return std::size_t(pEnd - pWrite);
+        }
+
+        template <typename T>
+        static std::size_t decode(const uint8_t* pRead, std::size_t nAvailable, message_header<T>& header, std::size_t& nBodySize, uint8_t& nFlags) {
+            const uint8_t* pEnd = pRead + nAvailable;
+            uint64_t nSizeAndFlags = 0;
+            const uint8_t* pNext = varint_decode(pRead, pEnd, nSizeAndFlags);
+            if (!pNext) {
+                return nAvailable >= nMaxVarintSize ? nFrameMalformed : nFrameIncomplete;
+            }
+            uint64_t nId = 0;
+            const uint8_t* pId = pNext;
+            pNext = varint_decode(pId, pEnd, nId);
+            if (!pNext) {
+                return std::size_t(pEnd - pId) >= nMaxVarintSize ? nFrameMalformed : nFrameIncomplete;
+            }
+            if (nId > uint64_t(std::numeric_limits<id_type<T>>::max())) {
+                return nFrameMalformed;
+            }
+            nBodySize = std::size_t(nSizeAndFlags >> nFlagBits);
+            nFlags = uint8_t(nSizeAndFlags & ((1u << nFlagBits) - 1));
+            header.id = T(id_type<T>(nId));
+            header.size = uint32_t(std::min<std::size_t>(sizeof(message_header<T>) + nBodySize, UINT32_MAX));
+            return std::size_t(pNext - pRead);
+        }
+    };
+
+}
@@ -1,6 +1,15 @@
 #pragma once
 
 #include "net_common.hpp"
+#include "net_tsqueue.hpp"
+#include "net_mpscqueue.hpp"
+#include "net_smallbuffer.hpp"
+#include "net_reflect.hpp"
+#include "net_varint.hpp"
+#include "net_compress.hpp"
+#include "net_framing.hpp"
+#include "net_crc32c.hpp"
+#include "net_bitpack.hpp"
 
 namespace net {
 
@@ -10,29 +19,141 @@ namespace net {
         uint32_t size = 0;
     };
 
+    struct default_message_traits {
+        static constexpr std::size_t nInlineBodySize = 128;
+        using framing = standard_framing;
+        static constexpr bool bLockFreeIncoming = false;
+    };
+
+    template <typename T>
+    struct message_traits : default_message_traits {
+    };
+
     template <typename T>
     struct message {
         message_header<T> header{};
-        std::vector<uint8_t> body;
+        small_buffer<message_traits<T>::nInlineBodySize> body;
 
         std::size_t size() const {
             return sizeof(message_header<T>) + body.size();
         }
 
+        void reserve(std::size_t nBodySize) {
+            body.reserve(nBodySize);
+        }
+
+        template <typename... DataTypes>
+        message<T>& push(const DataTypes&... data) {
+            static_assert((is_wire_fixed<DataTypes>() && ...), "Data is too complex to be pushed into vector.\n");
+
+            constexpr std::size_t nPushSize = (wire_size<DataTypes>() + ... + 0);
+
+            uint8_t* pWrite = body.append_uninitialized(nPushSize);
+
+            ((pWrite = wire_encode(pWrite, data)), ...);
+
+            header.size = uint32_t(size());
+
+            return *this;
+        }
+
         friend std::ostream& operator<<(std::ostream& os, const message<T>& msg) {
             return os << "ID: " << int(msg.header.id) << " Size: " << msg.header.size;
         }
 
         template<typename DataType>
         friend message<T>& operator<<(message<T>& msg, const DataType& data) {
-            static_assert(std::is_standard_layout<DataType>::value, "Data is too complex to be pushed into vector.\n");
+            static_assert(is_reflected<DataType>::value || std::is_standard_layout<DataType>::value, "Data is too complex to be pushed into vector.\n");
+
+            if constexpr (is_reflected<DataType>::value && !is_wire_fixed<DataType>()) {
+                std::apply([&msg, &data](auto... members) {
+                    ((msg << data.*members), ...);
+                }, reflect<DataType>::fields);
+            }
+            else {
+                wire_encode(msg.body.append_uninitialized(wire_size<DataType>()), data);
+
+                msg.header.size = msg.size();
+            }
+
+            return msg;
+        }
+
+        template <typename Int>
+        friend message<T>& operator<<(message<T>& msg, varint<Int> data) {
+            uint64_t nWire = varint_to_wire(data.value);
+
+            varint_encode(msg.body.append_uninitialized(varint_size(nWire)), nWire);
+
+            msg.header.size = msg.size();
+
+            return msg;
+        }
+
+        friend message<T>& operator<<(message<T>& msg, std::string_view str) {
+            msg << varint<uint64_t>{ str.size() };
+
+            if (!str.empty()) {
+                std::memcpy(msg.body.append_uninitialized(str.size()), str.data(), str.size());
+            }
+
+            msg.header.size = msg.size();
+
+            return msg;
+        }
+
+        friend message<T>& operator<<(message<T>& msg, const std::string& str) {
+            return msg << std::string_view(str);
+        }
+
+        friend message<T>& operator<<(message<T>& msg, const char* str) {
+            return msg << std::string_view(str);
+        }
+
+        template <typename Item, typename Allocator>
+        friend message<T>& operator<<(message<T>& msg, const std::vector<Item, Allocator>& vec) {
+            msg << varint<uint64_t>{ vec.size() };
+
+            if constexpr (!is_reflected<Item>::value && std::is_trivially_copyable<Item>::value) {
+                if (!vec.empty()) {
+                    std::memcpy(msg.body.append_uninitialized(vec.size() * sizeof(Item)), vec.data(), vec.size() * sizeof(Item));
+                }
+                msg.header.size = msg.size();
+            }
+            else {
+                for (const Item& item : vec) {
+                    msg << item;
+                }
+            }
+
+            return msg;
+        }
+
+        template <typename Key, typename Value, typename Compare, typename Allocator>
+        friend message<T>& operator<<(message<T>& msg, const std::map<Key, Value, Compare, Allocator>& map) {
+            msg << varint<uint64_t>{ map.size() };
+
+            for (const auto& [key, value] : map) {
+                msg << key << value;
+            }
+
+            return msg;
+        }
 
-            std::size_t i = msg.body.size();
+        template <typename Vector>
+        friend message<T>& operator<<(message<T>& msg, bitpacked<Vector> data) {
+            using Word = typename bitpacked<Vector>::word_type;
 
-            msg.body.resize(msg.body.size() + sizeof(DataType));
+            std::size_t nCount = data.values.size();
+            msg << varint<uint64_t>{ nCount };
+
+            if (nCount > 0) {
+                std::size_t nStart = msg.body.size();
+                uint8_t* pWrite = msg.body.append_uninitialized(bitpack_bound<Word>(nCount));
+                uint8_t* pEnd = bitpack_encode(pWrite, reinterpret_cast<const Word*>(data.values.data()), nCount);
+                msg.body.resize(nStart + std::size_t(pEnd - pWrite));
+            }
 
-            std::memcpy(msg.body.data() + i, &data, sizeof(DataType));
-            
             msg.header.size = msg.size();
 
             return msg;
@@ -40,11 +161,11 @@ namespace net {
 
         template <typename DataType>
         friend message<T>& operator>>(message<T>& msg, DataType& data) {
-            static_assert(std::is_standard_layout<DataType>::value, "Data is too complex to be pushed into vector.\n");
+            static_assert(is_reflected<DataType>::value || std::is_standard_layout<DataType>::value, "Data is too complex to be pushed into vector.\n");
 
-            std::size_t i = msg.body.size() - sizeof(DataType);
+            std::size_t i = msg.body.size() - wire_size<DataType>();
 
-            std::memcpy(&data, msg.body.data() + i, sizeof(DataType));
+            wire_decode(msg.body.data() + i, data);
 
             msg.body.resize(i);
 
@@ -54,6 +175,397 @@ namespace net {
         }
     };
     
+    struct byte_view {
+        const uint8_t* pData = nullptr;
+        std::size_t nSize = 0;
+
+        const uint8_t* data() const {
+            return pData;
+        }
+
+        std::size_t size() const {
+            return nSize;
+        }
+
+        bool empty() const {
+            return nSize == 0;
+        }
+
+        const uint8_t* begin() const {
+            return pData;
+        }
+
+        const uint8_t* end() const {
+            return pData + nSize;
+        }
+
+        const uint8_t& operator[](std::size_t i) const {
+            return pData[i];
+        }
+    };
+
+    template <typename T>
+    class message_view {
+    public:
+        explicit message_view(const message<T>& msg) :
+            m_pCursor(msg.body.data()), m_pEnd(msg.body.data() + msg.body.size()) {
+        }
+
+        message_view(const uint8_t* pData, std::size_t nSize) :
+            m_pCursor(pData), m_pEnd(pData + nSize) {
+        }
+
+        std::size_t remaining() const {
+            return std::size_t(m_pEnd - m_pCursor);
+        }
+
+        bool empty() const {
+            return m_pCursor == m_pEnd;
+        }
+
+        bool ok() const {
+            return !m_bFailed;
+        }
+
+        explicit operator bool() const {
+            return !m_bFailed;
+        }
+
+        template <typename DataType>
+        bool read(DataType& data) {
+            static_assert(is_wire_fixed<DataType>(), "Data is too complex to be read from view.\n");
+            if (!require(wire_size<DataType>())) {
+                return false;
+            }
+            m_pCursor = wire_decode(m_pCursor, data);
+            return true;
+        }
+
+        template <typename DataType>
+        bool read_back(DataType& data) {
+            static_assert(is_wire_fixed<DataType>(), "Data is too complex to be read from view.\n");
+            if (!require(wire_size<DataType>())) {
+                return false;
+            }
+            m_pEnd -= wire_size<DataType>();
+            wire_decode(m_pEnd, data);
+            return true;
+        }
+
+        bool read_varint(uint64_t& nValue) {
+            if (m_bFailed) {
+                return false;
+            }
+            const uint8_t* pNext = varint_decode(m_pCursor, m_pEnd, nValue);
+            if (!pNext) {
+                m_bFailed = true;
+                return false;
+            }
+            m_pCursor = pNext;
+            return true;
+        }
+
+        byte_view read_bytes(std::size_t nLength) {
+            if (!require(nLength)) {
+                return byte_view{};
+            }
+            byte_view bytes{ m_pCursor, nLength };
+            m_pCursor += nLength;
+            return bytes;
+        }
+
+        std::string_view read_string(std::size_t nLength) {
+            byte_view bytes = read_bytes(nLength);
+            return std::string_view(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+        }
+
+        byte_view read_remaining_bytes() {
+            return read_bytes(remaining());
+        }
+
+        std::string_view read_remaining_string() {
+            return read_string(remaining());
+        }
+
+        template <typename DataType>
+        friend message_view<T>& operator>>(message_view<T>& view, DataType& data) {
+            if constexpr (is_reflected<DataType>::value && !is_wire_fixed<DataType>()) {
+                std::apply([&view, &data](auto... members) {
+                    ((view >> data.*members), ...);
+                }, reflect<DataType>::fields);
+            }
+            else {
+                view.read(data);
+            }
+            return view;
+        }
+
+        template <typename Int>
+        friend message_view<T>& operator>>(message_view<T>& view, varint<Int>& data) {
+            uint64_t nWire = 0;
+            if (view.read_varint(nWire)) {
+                data.value = varint_from_wire<Int>(nWire);
+            }
+            return view;
+        }
+
+        friend message_view<T>& operator>>(message_view<T>& view, std::string_view& str) {
+            uint64_t nLength = 0;
+            if (view.read_varint(nLength)) {
+                str = view.read_string(std::size_t(nLength));
+            }
+            return view;
+        }
+
+        friend message_view<T>& operator>>(message_view<T>& view, std::string& str) {
+            std::string_view strView;
+            view >> strView;
+            str.assign(strView);
+            return view;
+        }
+
+        template <typename Item, typename Allocator>
+        friend message_view<T>& operator>>(message_view<T>& view, std::vector<Item, Allocator>& vec) {
+            uint64_t nCount = 0;
+            if (!view.read_varint(nCount) || !view.require_items(nCount, wire_size_hint<Item>())) {
+                return view;
+            }
+            if constexpr (!is_reflected<Item>::value && std::is_trivially_copyable<Item>::value) {
+                byte_view bytes = view.read_bytes(std::size_t(nCount) * sizeof(Item));
+                vec.resize(std::size_t(nCount));
+                if (!bytes.empty()) {
+                    std::memcpy(vec.data(), bytes.data(), bytes.size());
+                }
+            }
+            else {
+                vec.clear();
+                vec.reserve(std::size_t(nCount));
+                for (uint64_t i = 0; i < nCount && view.ok(); i++) {
+                    Item item{};
+                    view >> item;
+                    vec.emplace_back(std::move(item));
+                }
+            }
+            return view;
+        }
+
+        template <typename Key, typename Value, typename Compare, typename Allocator>
+        friend message_view<T>& operator>>(message_view<T>& view, std::map<Key, Value, Compare, Allocator>& map) {
+            uint64_t nCount = 0;
+            if (!view.read_varint(nCount) || !view.require_items(nCount, wire_size_hint<Key>() + wire_size_hint<Value>())) {
+                return view;
+            }
+            map.clear();
+            for (uint64_t i = 0; i < nCount && view.ok(); i++) {
+                Key key{};
+                Value value{};
+                view >> key >> value;
+                if (view.ok()) {
+                    map.emplace(std::move(key), std::move(value));
+                }
+            }
+            return view;
+        }
+
+        template <typename Vector>
+        friend message_view<T>& operator>>(message_view<T>& view, bitpacked<Vector> data) {
+            using Word = typename bitpacked<Vector>::word_type;
+
+            uint64_t nCount = 0;
+            if (!view.read_varint(nCount) || !view.require_items(nCount / nBitpackBlockSize + nCount % nBitpackBlockSize, 1)) {
+                return view;
+            }
+            if (nCount > data.nMaxCount) {
+                view.m_bFailed = true;
+                return view;
+            }
+            data.values.resize(std::size_t(nCount));
+            const uint8_t* pNext = bitpack_decode(view.m_pCursor, view.m_pEnd, reinterpret_cast<Word*>(data.values.data()), std::size_t(nCount));
+            if (!pNext) {
+                view.m_bFailed = true;
+                return view;
+            }
+            view.m_pCursor = pNext;
+            return view;
+        }
+
+    private:
+        template <typename Item>
+        static constexpr std::size_t wire_size_hint() {
+            if constexpr (is_wire_fixed<Item>()) {
+                return std::max<std::size_t>(wire_size<Item>(), 1);
+            }
+            else {
+                return 1;
+            }
+        }
+
+        bool require_items(uint64_t nCount, std::size_t nItemSize) {
+            if (m_bFailed || nCount > remaining() / nItemSize) {
+                m_bFailed = true;
+                return false;
+            }
+            return true;
+        }
+
+        bool require(std::size_t nLength) {
+            if (m_bFailed || remaining() < nLength) {
+                m_bFailed = true;
+                return false;
+            }
+            return true;
+        }
+
+        const uint8_t* m_pCursor;
+        const uint8_t* m_pEnd;
+        bool m_bFailed = false;
+    };
+
+    template <typename T>
+    class message_frame {
+    public:
+        using framing = typename message_traits<T>::framing;
+
+        explicit message_frame(message<T> msg, uint8_t nFlags = 0) : m_msg(std::move(msg)), m_nFlags(nFlags) {
+            m_msg.header.size = uint32_t(m_msg.size());
+            m_nHeaderSize = framing::encode(m_msg.header, m_msg.body.size(), m_nFlags, m_arrHeader.data());
+        }
+
+        message_frame(const message_frame<T>&) = delete;
+        message_frame<T>& operator=(const message_frame<T>&) = delete;
+
+        const message<T>& msg() const {
+            return m_msg;
+        }
+
+        std::size_t size() const {
+            return m_nHeaderSize + m_msg.body.size();
+        }
+
+        std::size_t buffer_count(bool bCompressed = false) const {
+            return bCompressed || !m_msg.body.empty() ? 2 : 1;
+        }
+
+        template <typename Buffers>
+        void append_buffers(Buffers& buffers, bool bCompressed = false) const {
+            if (bCompressed) {
+                buffers.emplace_back(asio::buffer(m_arrCompressedHeader.data(), m_nCompressedHeaderSize));
+                buffers.emplace_back(asio::buffer(m_vecCompressed));
+                return;
+            }
+            buffers.emplace_back(asio::buffer(m_arrHeader.data(), m_nHeaderSize));
+            if (!m_msg.body.empty()) {
+                buffers.emplace_back(asio::buffer(m_msg.body.data(), m_msg.body.size()));
+            }
+        }
+
+        bool compress(uint64_t& nNanoseconds) const {
+            std::call_once(m_compressOnce, [this, &nNanoseconds]() {
+                auto tStart = std::chrono::steady_clock::now();
+                std::size_t nBodySize = m_msg.body.size();
+                std::vector<uint8_t> vecCompressed(varint_size(nBodySize) + lz_compress_bound(nBodySize));
+                uint8_t* pPayload = varint_encode(vecCompressed.data(), nBodySize);
+                std::size_t nPrefix = std::size_t(pPayload - vecCompressed.data());
+                std::size_t nCompressed = lz_compress(m_msg.body.data(), nBodySize, pPayload, vecCompressed.size() - nPrefix);
+                if (nCompressed > 0 && nPrefix + nCompressed < nBodySize) {
+                    vecCompressed.resize(nPrefix + nCompressed);
+                    m_vecCompressed.swap(vecCompressed);
+                    m_nCompressedHeaderSize = framing::encode(m_msg.header, m_vecCompressed.size(), uint8_t(m_nFlags | nFrameFlagCompressed), m_arrCompressedHeader.data());
+                }
+                nNanoseconds = uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - tStart).count());
+            });
+            return !m_vecCompressed.empty();
+        }
+
+        std::size_t compressed_size() const {
+            return m_vecCompressed.size();
+        }
+
+        const uint32_t& checksum(bool bCompressed = false) const {
+            if (bCompressed) {
+                std::call_once(m_compressedChecksumOnce, [this]() {
+                    m_nCompressedChecksum = crc32c(crc32c(0, m_arrCompressedHeader.data(), m_nCompressedHeaderSize), m_vecCompressed.data(), m_vecCompressed.size());
+                });
+                return m_nCompressedChecksum;
+            }
+            std::call_once(m_checksumOnce, [this]() {
+                m_nChecksum = crc32c(crc32c(0, m_arrHeader.data(), m_nHeaderSize), m_msg.body.data(), m_msg.body.size());
+            });
+            return m_nChecksum;
+        }
+
+    private:
+        message<T> m_msg;
+        uint8_t m_nFlags = 0;
+        std::array<uint8_t, framing::template max_header_size<T>()> m_arrHeader;
+        std::size_t m_nHeaderSize = 0;
+        mutable std::once_flag m_compressOnce;
+        mutable std::vector<uint8_t> m_vecCompressed;
+        mutable std::array<uint8_t, framing::template max_header_size<T>()> m_arrCompressedHeader;
+        mutable std::size_t m_nCompressedHeaderSize = 0;
+        mutable std::once_flag m_checksumOnce;
+        mutable uint32_t m_nChecksum = 0;
+        mutable std::once_flag m_compressedChecksumOnce;
+        mutable uint32_t m_nCompressedChecksum = 0;
+    };
+
+    template <typename T>
+    using shared_frame = std::shared_ptr<const message_frame<T>>;
+
+    template <typename T>
+    shared_frame<T> make_frame(message<T> msg) {
+        return std::make_shared<const message_frame<T>>(std::move(msg));
+    }
+
+    template <typename T>
+    class message_batch {
+    public:
+        message_batch() = default;
+
+        message_batch<T>& append(const message<T>& msg) {
+            std::array<uint8_t, compact_framing::max_header_size<T>()> arrHeader;
+            std::size_t nHeaderSize = compact_framing::encode(msg.header, msg.body.size(), 0, arrHeader.data());
+            uint8_t* pWrite = m_msg.body.append_uninitialized(nHeaderSize + msg.body.size());
+            std::memcpy(pWrite, arrHeader.data(), nHeaderSize);
+            if (!msg.body.empty()) {
+                std::memcpy(pWrite + nHeaderSize, msg.body.data(), msg.body.size());
+            }
+            m_nCount++;
+            return *this;
+        }
+
+        void reserve(std::size_t nBytes) {
+            m_msg.body.reserve(nBytes);
+        }
+
+        std::size_t count() const {
+            return m_nCount;
+        }
+
+        std::size_t size() const {
+            return m_msg.body.size();
+        }
+
+        bool empty() const {
+            return m_nCount == 0;
+        }
+
+        void clear() {
+            m_msg.body.clear();
+            m_nCount = 0;
+        }
+
+        friend shared_frame<T> make_frame(message_batch<T>&& batch) {
+            static_assert(message_traits<T>::framing::bHasFlags, "Message batches need a framing with flag bits, such as compact_framing.\n");
+            batch.m_nCount = 0;
+            return std::make_shared<const message_frame<T>>(std::move(batch.m_msg), nFrameFlagBatch);
+        }
+
+    private:
+        message<T> m_msg;
+        std::size_t m_nCount = 0;
+    };
+
     template <typename T>
     class connection;
 
@@ -67,4 +579,7 @@ namespace net {
         }
     };
 
+    template <typename T>
+    using incoming_queue = std::conditional_t<message_traits<T>::bLockFreeIncoming, mpsc_queue<owned_message<T>>, tsqueue<owned_message<T>>>;
+
 }
\ No newline at end of file
@@ -0,0 +1,208 @@
+#pragma once
+
+#include "net_common.hpp"
+#include "net_ringqueue.hpp"
+
+namespace net {
+
+    template <typename T>
+    class mpsc_queue {
+    public:
+        mpsc_queue() {
+            node* pStub = Acquire();
+            m_pHead.store(pStub, std::memory_order_relaxed);
+            m_pTail = pStub;
+        }
+
+        mpsc_queue(const mpsc_queue<T>&) = delete;
+
+        ~mpsc_queue() {
+            clear();
+            Release(m_pTail);
+            for (std::size_t i = 0; i < nMaxChunks; i++) {
+                delete[] m_arrChunks[i].load(std::memory_order_relaxed);
+            }
+        }
+
+        const T& front() {
+            return *next().value;
+        }
+
+        void emplace_back(const T& item) {
+            node* pNode = Acquire();
+            pNode->value.emplace(item);
+            push(pNode, pNode, 1);
+        }
+
+        void emplace_back(T&& item) {
+            node* pNode = Acquire();
+            pNode->value.emplace(std::move(item));
+            push(pNode, pNode, 1);
+        }
+
+        void emplace_back_bulk(std::vector<T>& vecItems) {
+            if (vecItems.empty()) {
+                return;
+            }
+            node* pFirst = nullptr;
+            node* pLast = nullptr;
+            for (T& item : vecItems) {
+                node* pNode = Acquire();
+                pNode->value.emplace(std::move(item));
+                if (pLast) {
+                    pLast->pNext.store(pNode, std::memory_order_relaxed);
+                }
+                else {
+                    pFirst = pNode;
+                }
+                pLast = pNode;
+            }
+            std::size_t nCount = vecItems.size();
+            vecItems.clear();
+            push(pFirst, pLast, nCount);
+        }
+
+        bool empty() const {
+            return m_nSize.load(std::memory_order_acquire) == 0;
+        }
+
+        std::size_t size() const {
+            return m_nSize.load(std::memory_order_acquire);
+        }
+
+        void clear() {
+            while (!empty()) {
+                pop_front();
+            }
+        }
+
+        T pop_front() {
+            node* pNext = &next();
+            T item = std::move(*pNext->value);
+            pNext->value.reset();
+            Release(m_pTail);
+            m_pTail = pNext;
+            m_nSize.fetch_sub(1, std::memory_order_relaxed);
+            return item;
+        }
+
+        std::size_t drain(ring_queue<T>& qOut, std::size_t nMaxItems = -1) {
+            std::size_t nItems = std::min(nMaxItems, size());
+            for (std::size_t i = 0; i < nItems; i++) {
+                qOut.emplace_back(pop_front());
+            }
+            return nItems;
+        }
+
+        void wait() {
+            if (!empty()) {
+                return;
+            }
+            std::unique_lock<std::mutex> ul(muxBlocking);
+            cvBlocking.wait(ul, [this]() { return !empty(); });
+        }
+
+    private:
+        static constexpr std::size_t nChunkSize = 1024;
+        static constexpr std::size_t nMaxChunks = 1024;
+        static constexpr uint32_t nHeapNode = std::numeric_limits<uint32_t>::max();
+
+        struct node {
+            std::atomic<node*> pNext{ nullptr };
+            std::optional<T> value;
+            uint32_t nIndex = nHeapNode;
+            std::atomic<uint32_t> nFreeNext{ 0 };
+        };
+
+        void push(node* pFirst, node* pLast, std::size_t nCount) {
+            node* pPrev = m_pHead.exchange(pLast, std::memory_order_acq_rel);
+            pPrev->pNext.store(pFirst, std::memory_order_release);
+            if (m_nSize.fetch_add(nCount, std::memory_order_acq_rel) == 0) {
+                {
+                    std::scoped_lock lock(muxBlocking);
+                }
+                cvBlocking.notify_one();
+            }
+        }
+
+        node& next() {
+            node* pNext = m_pTail->pNext.load(std::memory_order_acquire);
+            while (!pNext) {
+                std::this_thread::yield();
+                pNext = m_pTail->pNext.load(std::memory_order_acquire);
+            }
+            return *pNext;
+        }
+
+        node* At(uint32_t nIndex) const {
+            return m_arrChunks[nIndex / nChunkSize].load(std::memory_order_acquire) + nIndex % nChunkSize;
+        }
+
+        node* Acquire() {
+            uint64_t nHead = m_nFreeHead.load(std::memory_order_acquire);
+            while (true) {
+                uint32_t nLink = uint32_t(nHead);
+                if (nLink == 0) {
+                    if (node* pNode = Grow()) {
+                        return pNode;
+                    }
+                    nHead = m_nFreeHead.load(std::memory_order_acquire);
+                    continue;
+                }
+                node* pNode = At(nLink - 1);
+                uint64_t nNext = ((nHead >> 32) + 1) << 32 | pNode->nFreeNext.load(std::memory_order_relaxed);
+                if (m_nFreeHead.compare_exchange_weak(nHead, nNext, std::memory_order_acquire, std::memory_order_acquire)) {
+                    pNode->pNext.store(nullptr, std::memory_order_relaxed);
+                    return pNode;
+                }
+            }
+        }
+
+        void Release(node* pNode) {
+            if (pNode->nIndex == nHeapNode) {
+                delete pNode;
+                return;
+            }
+            PushFree(pNode, pNode);
+        }
+
+        void PushFree(node* pFirst, node* pLast) {
+            uint64_t nHead = m_nFreeHead.load(std::memory_order_relaxed);
+            uint64_t nNext;
+            do {
+                pLast->nFreeNext.store(uint32_t(nHead), std::memory_order_relaxed);
+                nNext = ((nHead >> 32) + 1) << 32 | (pFirst->nIndex + 1);
+            } while (!m_nFreeHead.compare_exchange_weak(nHead, nNext, std::memory_order_release, std::memory_order_relaxed));
+        }
+
+        node* Grow() {
+            std::scoped_lock lock(m_muxGrow);
+            if (uint32_t(m_nFreeHead.load(std::memory_order_acquire)) != 0) {
+                return nullptr;
+            }
+            if (m_nChunks == nMaxChunks) {
+                return new node();
+            }
+            node* pChunk = new node[nChunkSize];
+            uint32_t nBase = uint32_t(m_nChunks * nChunkSize);
+            for (std::size_t i = 0; i < nChunkSize; i++) {
+                pChunk[i].nIndex = nBase + uint32_t(i);
+                pChunk[i].nFreeNext.store(nBase + uint32_t(i) + 2, std::memory_order_relaxed);
+            }
+            m_arrChunks[m_nChunks++].store(pChunk, std::memory_order_release);
+            PushFree(&pChunk[1], &pChunk[nChunkSize - 1]);
+            return &pChunk[0];
+        }
+
+        alignas(64) std::atomic<node*> m_pHead{ nullptr };
+        alignas(64) node* m_pTail = nullptr;
+        alignas(64) std::atomic<std::size_t> m_nSize{ 0 };
+        alignas(64) std::atomic<uint64_t> m_nFreeHead{ 0 };
+        std::array<std::atomic<node*>, nMaxChunks> m_arrChunks{};
+        std::size_t m_nChunks = 0;
+        std::mutex m_muxGrow;
+        std::condition_variable cvBlocking;
+        std::mutex muxBlocking;
+    };
+
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "net_common.hpp"
+
+namespace net {
+
+    template <typename T>
+    struct reflect {
+    };
+
+    template <typename T, typename = void>
+    struct is_reflected : std::false_type {
+    };
+
+    template <typename T>
+    struct is_reflected<T, std::void_t<decltype(reflect<T>::fields)>> : std::true_type {
+    };
+
+    template <typename... Members>
+    constexpr auto fields(Members... members) {
+        return std::make_tuple(members...);
+    }
+
+    template <typename Member>
+    struct member_type;
+
+    template <typename Class, typename Member>
+    struct member_type<Member Class::*> {
+        using type = Member;
+    };
+
+    template <typename DataType>
+    constexpr bool is_wire_fixed() {
+        if constexpr (is_reflected<DataType>::value) {
+            return std::apply([](auto... members) {
+                return (is_wire_fixed<typename member_type<decltype(members)>::type>() && ... && true);
+            }, reflect<DataType>::fields);
+        }
+        else {
+            return std::is_trivially_copyable<DataType>::value;
+        }
+    }
+
+    template <typename DataType>
+    constexpr std::size_t wire_size() {
+        if constexpr (is_reflected<DataType>::value) {
+            return std::apply([](auto... members) {
+                return (wire_size<typename member_type<decltype(members)>::type>() + ... + 0);
+            }, reflect<DataType>::fields);
+        }
+        else {
+            return sizeof(DataType);
+        }
+    }
+
+    template <typename DataType>
+    constexpr bool is_wire_contiguous() {
+        if constexpr (is_reflected<DataType>::value && is_wire_fixed<DataType>()) {
+            return std::is_trivially_copyable<DataType>::value && std::is_default_constructible<DataType>::value && sizeof(DataType) == wire_size<DataType>();
+        }
+        else {
+            return false;
+        }
+    }
+
+    template <typename DataType>
+    bool is_field_order_layout() {
+        static const bool bInOrder = []() {
+            const DataType object{};
+            const unsigned char* pBase = reinterpret_cast<const unsigned char*>(&object);
+            std::size_t nExpected = 0;
+            bool bMatches = true;
+            std::apply([&](auto... members) {
+                ((bMatches = bMatches && std::size_t(reinterpret_cast<const unsigned char*>(&(object.*members)) - pBase) == nExpected,
+                  nExpected += sizeof(object.*members)), ...);
+            }, reflect<DataType>::fields);
+            return bMatches;
+        }();
+        return bInOrder;
+    }
+
+    template <typename DataType>
+    uint8_t* wire_encode(uint8_t* pWrite, const DataType& data) {
+        if constexpr (is_reflected<DataType>::value) {
+            if constexpr (is_wire_contiguous<DataType>()) {
+                if (is_field_order_layout<DataType>()) {
+                    std::memcpy(pWrite, &data, sizeof(DataType));
+                    return pWrite + sizeof(DataType);
+                }
+            }
+            std::apply([&](auto... members) {
+                ((pWrite = wire_encode(pWrite, data.*members)), ...);
+            }, reflect<DataType>::fields);
+            return pWrite;
+        }
+        else {
+            static_assert(std::is_trivially_copyable<DataType>::value, "Fields must be trivially copyable or reflected.\n");
+            std::memcpy(pWrite, &data, sizeof(DataType));
+            return pWrite + sizeof(DataType);
+        }
+    }
+
+    template <typename DataType>
+    const uint8_t* wire_decode(const uint8_t* pRead, DataType& data) {
+        if constexpr (is_reflected<DataType>::value) {
+            if constexpr (is_wire_contiguous<DataType>()) {
+                if (is_field_order_layout<DataType>()) {
+                    std::memcpy(&data, pRead, sizeof(DataType));
+                    return pRead + sizeof(DataType);
+                }
+            }
+            std::apply([&](auto... members) {
+                ((pRead = wire_decode(pRead, data.*members)), ...);
+            }, reflect<DataType>::fields);
+            return pRead;
+        }
+        else {
+            static_assert(std::is_trivially_copyable<DataType>::value, "Fields must be trivially copyable or reflected.\n");
+            std::memcpy(&data, pRead, sizeof(DataType));
+            return pRead + sizeof(DataType);
+        }
+    }
+
+}
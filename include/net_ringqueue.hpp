@@ -0,0 +1,91 @@
+#pragma once
+
+#include "net_common.hpp"
+
+namespace net {
+
+    template <typename T>
+    class ring_queue {
+    public:
+        ring_queue() = default;
+        ring_queue(const ring_queue<T>&) = delete;
+
+        T& front() {
+            return vecRing[nHead];
+        }
+
+        T& back() {
+            return vecRing[(nHead + nCount - 1) & (vecRing.size() - 1)];
+        }
+
+        void emplace_back(T&& item) {
+            if (nCount == vecRing.size()) {
+                grow();
+            }
+            vecRing[(nHead + nCount) & (vecRing.size() - 1)] = std::move(item);
+            nCount++;
+        }
+
+        void emplace_back(const T& item) {
+            emplace_back(T(item));
+        }
+
+        void emplace_front(T&& item) {
+            if (nCount == vecRing.size()) {
+                grow();
+            }
+            nHead = (nHead - 1) & (vecRing.size() - 1);
+            vecRing[nHead] = std::move(item);
+            nCount++;
+        }
+
+        void emplace_front(const T& item) {
+            emplace_front(T(item));
+        }
+
+        bool empty() const {
+            return nCount == 0;
+        }
+
+        std::size_t size() const {
+            return nCount;
+        }
+
+        void clear() {
+            while (!empty()) {
+                pop_front();
+            }
+        }
+
+        T pop_front() {
+            T t = std::move(vecRing[nHead]);
+            vecRing[nHead] = T();
+            nHead = (nHead + 1) & (vecRing.size() - 1);
+            nCount--;
+            return t;
+        }
+
+        T pop_back() {
+            std::size_t nTail = (nHead + nCount - 1) & (vecRing.size() - 1);
+            T t = std::move(vecRing[nTail]);
+            vecRing[nTail] = T();
+            nCount--;
+            return t;
+        }
+
+    protected:
+        std::vector<T> vecRing;
+        std::size_t nHead = 0;
+        std::size_t nCount = 0;
+
+        void grow() {
+            std::vector<T> vecGrown(vecRing.empty() ? 16 : vecRing.size() * 2);
+            for (std::size_t i = 0; i < nCount; i++) {
+                vecGrown[i] = std::move(vecRing[(nHead + i) & (vecRing.size() - 1)]);
+            }
+            vecRing.swap(vecGrown);
+            nHead = 0;
+        }
+    };
+
+}
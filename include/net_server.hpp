@@ -11,6 +11,9 @@ namespace net {
     class server_interface {
     public:
         server_interface(uint16_t port) : m_asioAcceptor(m_asioContext, asio::ip::tcp::endpoint(asio::ip::tcp::v4(), port)) {
+#if defined(ASIO_HAS_IO_URING)
+            SetReadBufferPool(256, 16 * 1024);
+#endif
         }
 
         virtual ~server_interface() {
@@ -39,11 +42,19 @@ namespace net {
         }
 
         void WaitForClientConnection() {
-            m_asioAcceptor.async_accept(
+            m_asioAcceptor.async_accept(asio::make_strand(m_asioContext),
                 [this](std::error_code ec, asio::ip::tcp::socket socket) {
                     if (!ec) {
                         std::cout << "[SERVER] New connection: " << socket.remote_endpoint() << '\n';
                         std::shared_ptr<connection<T>> newconn = std::make_shared<connection<T>>(connection<T>::owner::server, m_asioContext, std::move(socket), m_qMessagesIn);
+                        newconn->SetOutboundLimits(m_outboundLimits);
+                        newconn->SetInboundLimits(m_inboundLimits);
+                        newconn->SetSocketOptions(m_socketOptions);
+                        newconn->SetReadBufferPool(m_pReadPool);
+                        newconn->SetBodyPool(m_pBodyPool);
+                        newconn->SetZeroCopyThreshold(m_nZeroCopyThreshold);
+                        newconn->SetCompressionThreshold(m_nCompressionThreshold);
+                        newconn->SetChecksumsEnabled(m_bChecksums);
                         if (OnClientConnect(newconn)) {
                             m_deqConnections.emplace_back(std::move(newconn));
                             m_deqConnections.back()->ConnectToClient(this, nIDCounter++);
@@ -62,8 +73,22 @@ namespace net {
         }
 
         void MessageClient(std::shared_ptr<connection<T>> client, const message<T>& msg) {
+            MessageClient(std::move(client), message<T>(msg));
+        }
+
+        void MessageClient(std::shared_ptr<connection<T>> client, message<T>&& msg) {
+            MessageClient(std::move(client), make_frame(std::move(msg)));
+        }
+
+        void MessageClient(std::shared_ptr<connection<T>> client, message_batch<T>&& batch) {
+            if (!batch.empty()) {
+                MessageClient(std::move(client), make_frame(std::move(batch)));
+            }
+        }
+
+        void MessageClient(std::shared_ptr<connection<T>> client, const shared_frame<T>& frame) {
             if (client && client->IsConnected()) {
-                client->Send(msg);
+                client->Send(frame);
             }
             else {
                 OnClientDisconnect(client);
@@ -73,13 +98,27 @@ namespace net {
         }
 
         void MessageAllClients(const message<T>& msg, std::shared_ptr<connection<T>> pIgnoreClient = nullptr) {
+            MessageAllClients(make_frame(msg), std::move(pIgnoreClient));
+        }
+
+        void MessageAllClients(message<T>&& msg, std::shared_ptr<connection<T>> pIgnoreClient = nullptr) {
+            MessageAllClients(make_frame(std::move(msg)), std::move(pIgnoreClient));
+        }
+
+        void MessageAllClients(message_batch<T>&& batch, std::shared_ptr<connection<T>> pIgnoreClient = nullptr) {
+            if (!batch.empty()) {
+                MessageAllClients(make_frame(std::move(batch)), std::move(pIgnoreClient));
+            }
+        }
+
+        void MessageAllClients(const shared_frame<T>& frame, std::shared_ptr<connection<T>> pIgnoreClient = nullptr) {
             bool bInvalidClientExists = false;
             for (auto& client : m_deqConnections)
             {
                 if (client && client->IsConnected())
                 {
                     if(client != pIgnoreClient) {
-                        client->Send(msg);
+                        client->Send(frame, false);
                     }
                 }
                 else
@@ -98,11 +137,10 @@ namespace net {
             if (bWait) {
                 m_qMessagesIn.wait();
             }
-            std::size_t nMessageCount = 0;
-            while (nMessageCount < nMaxMessages && !m_qMessagesIn.empty()) {
-                auto msg = m_qMessagesIn.pop_front();
+            m_qMessagesIn.drain(m_qMessagesDrained, nMaxMessages);
+            while (!m_qMessagesDrained.empty()) {
+                auto msg = m_qMessagesDrained.pop_front();
                 OnMessage(msg.remote, msg.msg);
-                nMessageCount++;
             }
         }
 
@@ -110,15 +148,70 @@ namespace net {
             
         }
 
-    protected:
-        tsqueue<owned_message<T>> m_qMessagesIn;
-        std::deque<std::shared_ptr<connection<T>>> m_deqConnections;
+        virtual std::shared_ptr<body_stream<T>> OnStreamBegin(std::shared_ptr<connection<T>> client, const message_header<T>& header) {
+            return nullptr;
+        }
 
+        virtual void OnClientHighWatermark(std::shared_ptr<connection<T>> client) {
+
+        }
+
+        virtual void OnClientLowWatermark(std::shared_ptr<connection<T>> client) {
+
+        }
+
+        void SetOutboundLimits(const outbound_limits& limits) {
+            m_outboundLimits = limits;
+        }
+
+        void SetInboundLimits(const inbound_limits& limits) {
+            m_inboundLimits = limits;
+        }
+
+        void SetSocketOptions(const socket_options& options) {
+            m_socketOptions = options;
+        }
+
+        void SetCompressionThreshold(std::size_t nBytes) {
+            m_nCompressionThreshold = nBytes;
+        }
+
+        void SetChecksumsEnabled(bool bEnabled) {
+            m_bChecksums = bEnabled;
+        }
+
+        void SetZeroCopyThreshold(std::size_t nBytes) {
+            m_nZeroCopyThreshold = nBytes;
+        }
+
+        void SetReadBufferPool(std::size_t nBuffers, std::size_t nBufferSize) {
+            m_pReadPool.reset();
+            m_pReadPool = std::make_shared<read_buffer_pool>(m_asioContext, nBuffers, nBufferSize);
+        }
+
+        void SetBodyPool(std::size_t nMaxPooledSize, std::size_t nMaxPerClass) {
+            m_pBodyPool = std::make_shared<body_pool>(nMaxPooledSize, nMaxPerClass);
+        }
+
+    protected:
         asio::io_context m_asioContext;
         std::thread m_threadContext;
 
+        incoming_queue<T> m_qMessagesIn;
+        ring_queue<owned_message<T>> m_qMessagesDrained;
+        std::deque<std::shared_ptr<connection<T>>> m_deqConnections;
+
         asio::ip::tcp::acceptor m_asioAcceptor;
 
+        outbound_limits m_outboundLimits;
+        inbound_limits m_inboundLimits;
+        socket_options m_socketOptions;
+        std::shared_ptr<read_buffer_pool> m_pReadPool;
+        std::shared_ptr<body_pool> m_pBodyPool = std::make_shared<body_pool>();
+        std::size_t m_nZeroCopyThreshold = 0;
+        std::size_t m_nCompressionThreshold = 0;
+        bool m_bChecksums = false;
+
         uint32_t nIDCounter = 10000;
         virtual bool OnClientConnect(std::shared_ptr<connection<T>> client) {
             return false;
@@ -0,0 +1,193 @@
+#pragma once
+
+#include "net_common.hpp"
+#include "net_bufferpool.hpp"
+
+namespace net {
+
+    template <std::size_t N>
+    class small_buffer {
+    public:
+        small_buffer() = default;
+
+        small_buffer(const small_buffer<N>& other) {
+            assign(other.data(), other.size());
+        }
+
+        small_buffer(small_buffer<N>&& other) noexcept {
+            steal(other);
+        }
+
+        ~small_buffer() {
+            release();
+        }
+
+        small_buffer<N>& operator=(const small_buffer<N>& other) {
+            if (this != &other) {
+                assign(other.data(), other.size());
+            }
+            return *this;
+        }
+
+        small_buffer<N>& operator=(small_buffer<N>&& other) noexcept {
+            if (this != &other) {
+                release();
+                steal(other);
+            }
+            return *this;
+        }
+
+        uint8_t* data() {
+            return pHeap ? pHeap : arrInline.data();
+        }
+
+        const uint8_t* data() const {
+            return pHeap ? pHeap : arrInline.data();
+        }
+
+        uint8_t* begin() {
+            return data();
+        }
+
+        uint8_t* end() {
+            return data() + nSize;
+        }
+
+        const uint8_t* begin() const {
+            return data();
+        }
+
+        const uint8_t* end() const {
+            return data() + nSize;
+        }
+
+        uint8_t& operator[](std::size_t i) {
+            return data()[i];
+        }
+
+        const uint8_t& operator[](std::size_t i) const {
+            return data()[i];
+        }
+
+        std::size_t size() const {
+            return nSize;
+        }
+
+        std::size_t capacity() const {
+            return nCapacity;
+        }
+
+        bool empty() const {
+            return nSize == 0;
+        }
+
+        void clear() {
+            nSize = 0;
+        }
+
+        void reserve(std::size_t nNewCapacity) {
+            if (nNewCapacity <= nCapacity) {
+                return;
+            }
+            nNewCapacity = std::max(nNewCapacity, nCapacity * 2);
+            uint8_t* pNew = nullptr;
+            if (pPool) {
+                std::tie(pNew, nNewCapacity) = pPool->Acquire(nNewCapacity);
+            }
+            else {
+                pNew = new uint8_t[nNewCapacity];
+            }
+            if (nSize > 0) {
+                std::memcpy(pNew, data(), nSize);
+            }
+            std::size_t nOldSize = nSize;
+            release();
+            pHeap = pNew;
+            nCapacity = nNewCapacity;
+            nSize = nOldSize;
+        }
+
+        void resize(std::size_t nNewSize) {
+            reserve(nNewSize);
+            if (nNewSize > nSize) {
+                std::memset(data() + nSize, 0, nNewSize - nSize);
+            }
+            nSize = nNewSize;
+        }
+
+        void set_pool(std::shared_ptr<body_pool> pool) {
+            if (!pHeap) {
+                pPool = std::move(pool);
+            }
+        }
+
+        uint8_t* append_uninitialized(std::size_t nLength) {
+            reserve(nSize + nLength);
+            uint8_t* pAppended = data() + nSize;
+            nSize += nLength;
+            return pAppended;
+        }
+
+        void push_back(uint8_t value) {
+            reserve(nSize + 1);
+            data()[nSize++] = value;
+        }
+
+        void assign(const uint8_t* pData, std::size_t nLength) {
+            nSize = 0;
+            reserve(nLength);
+            if (nLength > 0) {
+                std::memcpy(data(), pData, nLength);
+            }
+            nSize = nLength;
+        }
+
+        friend bool operator==(const small_buffer<N>& lhs, const small_buffer<N>& rhs) {
+            return lhs.size() == rhs.size() && (lhs.empty() || std::memcmp(lhs.data(), rhs.data(), lhs.size()) == 0);
+        }
+
+        friend bool operator!=(const small_buffer<N>& lhs, const small_buffer<N>& rhs) {
+            return !(lhs == rhs);
+        }
+
+    private:
+        void release() {
+            if (pHeap) {
+                if (pPool) {
+                    pPool->Release(pHeap, nCapacity);
+                }
+                else {
+                    delete[] pHeap;
+                }
+                pHeap = nullptr;
+            }
+            nCapacity = N;
+            nSize = 0;
+        }
+
+        void steal(small_buffer<N>& other) {
+            if (other.pHeap) {
+                pHeap = other.pHeap;
+                pPool = std::move(other.pPool);
+                nCapacity = other.nCapacity;
+                other.pHeap = nullptr;
+                other.nCapacity = N;
+            }
+            else {
+                if (other.nSize > 0) {
+                    std::memcpy(arrInline.data(), other.arrInline.data(), other.nSize);
+                }
+                nCapacity = N;
+            }
+            nSize = other.nSize;
+            other.nSize = 0;
+        }
+
+        std::array<uint8_t, N> arrInline;
+        uint8_t* pHeap = nullptr;
+        std::shared_ptr<body_pool> pPool;
+        std::size_t nSize = 0;
+        std::size_t nCapacity = N;
+    };
+
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "net_common.hpp"
+
+namespace net {
+
+    struct socket_options {
+        std::optional<bool> bNoDelay;
+        std::optional<int> nSendBufferSize;
+        std::optional<int> nReceiveBufferSize;
+        std::optional<bool> bQuickAck;
+        std::optional<int> nBusyPollMicroseconds;
+        std::optional<int> nNotSentLowWatermark;
+        std::optional<bool> bKeepAlive;
+        std::optional<int> nKeepAliveIdleSeconds;
+        std::optional<int> nKeepAliveIntervalSeconds;
+        std::optional<int> nKeepAliveCount;
+
+        static socket_options low_latency() {
+            socket_options options;
+            options.bNoDelay = true;
+            options.bQuickAck = true;
+            options.nBusyPollMicroseconds = 50;
+            options.nNotSentLowWatermark = 16 * 1024;
+            options.bKeepAlive = true;
+            options.nKeepAliveIdleSeconds = 30;
+            options.nKeepAliveIntervalSeconds = 5;
+            options.nKeepAliveCount = 3;
+            return options;
+        }
+
+        static socket_options bulk_throughput() {
+            socket_options options;
+            options.bNoDelay = false;
+            options.nSendBufferSize = 4 * 1024 * 1024;
+            options.nReceiveBufferSize = 4 * 1024 * 1024;
+            options.bKeepAlive = true;
+            options.nKeepAliveIdleSeconds = 120;
+            options.nKeepAliveIntervalSeconds = 30;
+            options.nKeepAliveCount = 5;
+            return options;
+        }
+    };
+
+    inline void apply_socket_options(asio::ip::tcp::socket& socket, const socket_options& options) {
+        std::error_code ec;
+        auto report = [&](const char* szName) {
+            if (ec) {
+                std::cout << "[SOCKET] Setting " << szName << " failed: " << ec.message() << '\n';
+                ec.clear();
+            }
+        };
+
+        if (options.bNoDelay) {
+            socket.set_option(asio::ip::tcp::no_delay(*options.bNoDelay), ec);
+            report("TCP_NODELAY");
+        }
+        if (options.nSendBufferSize) {
+            socket.set_option(asio::socket_base::send_buffer_size(*options.nSendBufferSize), ec);
+            report("SO_SNDBUF");
+        }
+        if (options.nReceiveBufferSize) {
+            socket.set_option(asio::socket_base::receive_buffer_size(*options.nReceiveBufferSize), ec);
+            report("SO_RCVBUF");
+        }
+        if (options.bKeepAlive) {
+            socket.set_option(asio::socket_base::keep_alive(*options.bKeepAlive), ec);
+            report("SO_KEEPALIVE");
+        }
+#if defined(__linux__)
+        if (options.bQuickAck) {
+            socket.set_option(asio::detail::socket_option::boolean<IPPROTO_TCP, TCP_QUICKACK>(*options.bQuickAck), ec);
+            report("TCP_QUICKACK");
+        }
+#if defined(SO_BUSY_POLL)
+        if (options.nBusyPollMicroseconds) {
+            socket.set_option(asio::detail::socket_option::integer<SOL_SOCKET, SO_BUSY_POLL>(*options.nBusyPollMicroseconds), ec);
+            report("SO_BUSY_POLL");
+        }
+#endif
+#if defined(TCP_NOTSENT_LOWAT)
+        if (options.nNotSentLowWatermark) {
+            socket.set_option(asio::detail::socket_option::integer<IPPROTO_TCP, TCP_NOTSENT_LOWAT>(*options.nNotSentLowWatermark), ec);
+            report("TCP_NOTSENT_LOWAT");
+        }
+#endif
+        if (options.nKeepAliveIdleSeconds) {
+            socket.set_option(asio::detail::socket_option::integer<IPPROTO_TCP, TCP_KEEPIDLE>(*options.nKeepAliveIdleSeconds), ec);
+            report("TCP_KEEPIDLE");
+        }
+        if (options.nKeepAliveIntervalSeconds) {
+            socket.set_option(asio::detail::socket_option::integer<IPPROTO_TCP, TCP_KEEPINTVL>(*options.nKeepAliveIntervalSeconds), ec);
+            report("TCP_KEEPINTVL");
+        }
+        if (options.nKeepAliveCount) {
+            socket.set_option(asio::detail::socket_option::integer<IPPROTO_TCP, TCP_KEEPCNT>(*options.nKeepAliveCount), ec);
+            report("TCP_KEEPCNT");
+        }
+#endif
+    }
+
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "net_common.hpp"
+#include "net_ringqueue.hpp"
 
 namespace net {
 
@@ -31,6 +32,28 @@ namespace net {
             cvBlocking.notify_one();
         }
 
+        void emplace_back(T&& item) {
+            std::scoped_lock lock(muxQueue);
+            deqQueue.emplace_back(std::move(item));
+
+            std::unique_lock<std::mutex> ul(muxBlocking);
+            cvBlocking.notify_one();
+        }
+
+        void emplace_back_bulk(std::vector<T>& vecItems) {
+            if (vecItems.empty()) {
+                return;
+            }
+            std::scoped_lock lock(muxQueue);
+            for (T& item : vecItems) {
+                deqQueue.emplace_back(std::move(item));
+            }
+            vecItems.clear();
+
+            std::unique_lock<std::mutex> ul(muxBlocking);
+            cvBlocking.notify_one();
+        }
+
         void emplace_front(const T& item) {
             std::scoped_lock lock(muxQueue);
             deqQueue.emplace_front(std::move(item));
@@ -39,6 +62,14 @@ namespace net {
             cvBlocking.notify_one();
         }
 
+        void emplace_front(T&& item) {
+            std::scoped_lock lock(muxQueue);
+            deqQueue.emplace_front(std::move(item));
+
+            std::unique_lock<std::mutex> ul(muxBlocking);
+            cvBlocking.notify_one();
+        }
+
         bool empty() {
             std::scoped_lock lock(muxQueue);
             return deqQueue.empty();
@@ -68,6 +99,16 @@ namespace net {
             return t;
         }
 
+        std::size_t drain(ring_queue<T>& qOut, std::size_t nMaxItems = -1) {
+            std::scoped_lock lock(muxQueue);
+            std::size_t nItems = std::min(nMaxItems, deqQueue.size());
+            for (std::size_t i = 0; i < nItems; i++) {
+                qOut.emplace_back(std::move(deqQueue.front()));
+                deqQueue.pop_front();
+            }
+            return nItems;
+        }
+
         void wait() {
             while (empty()) {
                 std::unique_lock<std::mutex> ul(muxBlocking);
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "net_common.hpp"
+
+namespace net {
+
+    template <typename Int>
+    struct varint {
+        static_assert(std::is_integral<Int>::value, "Varints only hold integers.\n");
+        Int value{};
+    };
+
+    template <typename Int>
+    varint(Int) -> varint<Int>;
+
+    inline uint64_t zigzag_encode(int64_t nValue) {
+        return (uint64_t(nValue) << 1) ^ uint64_t(nValue >> 63);
+    }
+
+    inline int64_t zigzag_decode(uint64_t nValue) {
+        return int64_t(nValue >> 1) ^ -int64_t(nValue & 1);
+    }
+
+    inline std::size_t varint_size(uint64_t nValue) {
+        std::size_t nSize = 1;
+        while (nValue >= 0x80) {
+            nValue >>= 7;
+            nSize++;
+        }
+        return nSize;
+    }
+
+    inline uint8_t* varint_encode(uint8_t* pWrite, uint64_t nValue) {
+        while (nValue >= 0x80) {
+            *pWrite++ = uint8_t(nValue) | 0x80;
+            nValue >>= 7;
+        }
+        *pWrite++ = uint8_t(nValue);
+        return pWrite;
+    }
+
+    inline const uint8_t* varint_decode(const uint8_t* pRead, const uint8_t* pEnd, uint64_t& nValue) {
+        nValue = 0;
+        for (unsigned nShift = 0; pRead < pEnd && nShift < 64; nShift += 7) {
+            uint8_t nByte = *pRead++;
+            nValue |= uint64_t(nByte & 0x7F) << nShift;
+            if ((nByte & 0x80) == 0) {
+                return pRead;
+            }
+        }
+        return nullptr;
+    }
+
+    template <typename Int>
+    uint64_t varint_to_wire(Int nValue) {
+        if constexpr (std::is_signed<Int>::value) {
+            return zigzag_encode(int64_t(nValue));
+        }
+        else {
+            return uint64_t(nValue);
+        }
+    }
+
+    template <typename Int>
+    Int varint_from_wire(uint64_t nValue) {
+        if constexpr (std::is_signed<Int>::value) {
+            return Int(zigzag_decode(nValue));
+        }
+        else {
+            return Int(nValue);
+        }
+    }
+
+}
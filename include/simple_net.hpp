@@ -13,38 +13,10 @@ struct TextMessage {
     std::string content;
 };
 
-net::message<MessageType>& operator<<(net::message<MessageType>& msg, const std::string& str) {
-    std::size_t len = str.length();
-    std::size_t i = msg.body.size();
-    msg.body.resize(msg.body.size() + len);
-    std::memcpy(msg.body.data() + i, str.data(), len);
-    msg.header.size = msg.size();
-    return msg;
-}
-
-net::message<MessageType>& operator>>(net::message<MessageType>& msg, std::string& str) {
-    std::size_t len = msg.body.size();
-    str.resize(len);
-    std::memcpy(str.data(), msg.body.data(), len);
-    msg.body.clear();
-    msg.header.size = msg.size();
-    return msg;
-}
-
-net::message<MessageType>& operator<<(net::message<MessageType>& msg, const TextMessage& txtmsg) {
-    msg << txtmsg.username << txtmsg.content << uint8_t(txtmsg.username.length());
-    return msg;
-}
-
-net::message<MessageType>& operator>>(net::message<MessageType>& msg, TextMessage& txtmsg) {
-    uint8_t len;
-    msg >> len;
-    std::string user_and_content;
-    msg >> user_and_content;
-    txtmsg.username = user_and_content.substr(0, len);
-    txtmsg.content = user_and_content.substr(len);
-    return msg;
-}
+template <>
+struct net::reflect<TextMessage> {
+    static constexpr auto fields = net::fields(&TextMessage::username, &TextMessage::content);
+};
 
 class CustomClient : public net::client_interface<MessageType> {
 public:
@@ -78,25 +50,28 @@ public:
             msg.header.id = MessageType::MessageToClient;
             msg << txtmsg;
         }
-        Send(msg);
+        Send(std::move(msg));
     }
 
     void Update(bool bWait = false) {
         if (bWait) {
             Incoming().wait();
         }
-        while (!Incoming().empty()) {
-            net::message<MessageType> msg = Incoming().pop_front().msg;
+        Incoming().drain(qMessages);
+        while (!qMessages.empty()) {
+            net::message<MessageType> msg = qMessages.pop_front().msg;
             switch (msg.header.id) {
                 case MessageType::MessageToAll: {
-                    std::string content;
-                    msg >> content;
+                    net::message_view<MessageType> view(msg);
+                    std::string_view content;
+                    view >> content;
                     std::cout << "[ALL]: " << content << '\n';
                     break;
                 }
                 case MessageType::MessageToClient: {
+                    net::message_view<MessageType> view(msg);
                     TextMessage txtmsg;
-                    msg >> txtmsg;
+                    view >> txtmsg;
                     std::cout << "[" << txtmsg.username << "]: " << txtmsg.content << '\n';
                     break;
                 }
@@ -104,7 +79,7 @@ public:
                     net::message<MessageType> msg;
                     msg.header.id = MessageType::ClientRegister;
                     msg << strUsername;
-                    Send(msg);
+                    Send(std::move(msg));
                     bRegistered = true;
                     break;
                 }
@@ -118,6 +93,7 @@ public:
 private:
     const std::string strUsername;
     bool bRegistered = false;
+    net::ring_queue<net::owned_message<MessageType>> qMessages;
 };
 
 class CustomServer : public net::server_interface<MessageType> {
@@ -135,7 +111,7 @@ public:
     void OnClientValidated(std::shared_ptr<net::connection<MessageType>> pClient) override {
         net::message<MessageType> msg;
         msg.header.id = MessageType::ValidateClient;
-        MessageClient(pClient, msg);
+        MessageClient(pClient, std::move(msg));
     }
 
 protected:
@@ -144,36 +120,42 @@ protected:
     void OnMessage(std::shared_ptr<net::connection<MessageType>> pClient, net::message<MessageType>& msg) override {
         switch(msg.header.id) {
             case MessageType::MessageToServer: {
-                std::string content;
-                msg >> content;
+                net::message_view<MessageType> view(msg);
+                std::string_view content;
+                view >> content;
                 std::cout << "[" << mapUsers[pClient->GetID()] << "] -> [SERVER]: " << content << '\n';
                 break;
             }
             case MessageType::MessageToAll: {
                 MessageAllClients(msg, pClient);
-                std::string content;
-                msg >> content;
+                net::message_view<MessageType> view(msg);
+                std::string_view content;
+                view >> content;
                 std::cout << "[" << mapUsers[pClient->GetID()] << "] -> [ALL]: " << content << '\n';
                 break;
             }
             case MessageType::MessageToClient: {
-                TextMessage txtmsg{};
-                msg >> txtmsg;
-                std::cout << "[" << mapUsers[pClient->GetID()] << "] -> [" << txtmsg.username << "]: " << txtmsg.content << '\n';
+                net::message_view<MessageType> view(msg);
+                std::string_view username, content;
+                view >> username >> content;
+                const std::string& sender = mapUsers[pClient->GetID()];
+                std::cout << "[" << sender << "] -> [" << username << "]: " << content << '\n';
                 for (const auto& c : m_deqConnections) {
-                    if (mapUsers[c->GetID()] == txtmsg.username) {
-                        txtmsg.username = mapUsers[pClient->GetID()];
-                        msg << txtmsg;
-                        MessageClient(c, msg);
+                    if (mapUsers[c->GetID()] == username) {
+                        net::message<MessageType> reply;
+                        reply.header.id = MessageType::MessageToClient;
+                        reply << sender << content;
+                        MessageClient(c, std::move(reply));
                         break;
                     }
                 }
                 break;
             }
             case MessageType::ClientRegister: {
-                std::string username;
-                msg >> username;
-                mapUsers[pClient->GetID()] = username;
+                net::message_view<MessageType> view(msg);
+                std::string_view username;
+                view >> username;
+                mapUsers[pClient->GetID()] = std::string(username);
                 std::cout << "[" << pClient->GetID() << "] Registered as [" << username << "]\n";
                 break;
             }